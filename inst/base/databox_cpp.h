@@ -27,7 +27,7 @@ double databox::mtime(double time) {
 }
 
 double databox::tad() {
-  static double told = -1.;
+  static MRGSOLVE_THREAD_LOCAL double told = -1.;
   if(newind <= 1) told = -1.0;
   if((evid == 1) || (evid == 4)) told = time;
   return told < 0 ? -1.0 : time - told;
@@ -0,0 +1,158 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file dual.h
+ */
+
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <math.h>
+
+/**
+ * @brief A value and its derivative with respect to one parameter.
+ *
+ * Arithmetic on <code>dual</code> numbers carries the derivative along
+ * with the value (forward-mode differentiation), so code that is written
+ * once for <code>double</code> and <code>dual</code> gives the exact
+ * derivative of its result.  Comparisons only look at the value, except
+ * that a <code>dual</code> is only equal to zero when its derivative is
+ * zero too.
+ *
+ * Models built with <code>$PLUGIN sens</code> also get a copy of
+ * <code>$MAIN</code>, <code>$ODE</code> and <code>$TABLE</code> that is
+ * compiled with <code>dual</code> numbers in place of the parameters, the
+ * amounts and the doubles the model declares; the functions below are
+ * what that code can call.
+ */
+class dual {
+public:
+  dual() : v(0.0), d(0.0) {}
+  dual(const double v_) : v(v_), d(0.0) {}
+  dual(const double v_, const double d_) : v(v_), d(d_) {}
+  double v; ///< value
+  double d; ///< derivative
+};
+
+inline dual operator-(const dual& a) {
+  return dual(-a.v, -a.d);
+}
+inline dual operator+(const dual& a, const dual& b) {
+  return dual(a.v + b.v, a.d + b.d);
+}
+inline dual operator-(const dual& a, const dual& b) {
+  return dual(a.v - b.v, a.d - b.d);
+}
+inline dual operator*(const dual& a, const dual& b) {
+  return dual(a.v*b.v, a.d*b.v + a.v*b.d);
+}
+inline dual operator/(const dual& a, const dual& b) {
+  const double q = a.v/b.v;
+  return dual(q, (a.d - q*b.d)/b.v);
+}
+inline dual operator+(const dual& a) {
+  return a;
+}
+inline dual& operator+=(dual& a, const dual& b) {
+  a.v += b.v;
+  a.d += b.d;
+  return a;
+}
+inline dual& operator-=(dual& a, const dual& b) {
+  a.v -= b.v;
+  a.d -= b.d;
+  return a;
+}
+inline dual& operator*=(dual& a, const dual& b) {
+  a = a*b;
+  return a;
+}
+inline dual& operator/=(dual& a, const dual& b) {
+  a = a/b;
+  return a;
+}
+inline bool operator>(const dual& a, const dual& b) {return a.v > b.v;}
+inline bool operator<(const dual& a, const dual& b) {return a.v < b.v;}
+inline bool operator>=(const dual& a, const dual& b) {return a.v >= b.v;}
+inline bool operator<=(const dual& a, const dual& b) {return a.v <= b.v;}
+inline bool operator==(const dual& a, const dual& b) {
+  return (a.v == b.v) && (a.d == b.d);
+}
+inline bool operator!=(const dual& a, const dual& b) {return !(a == b);}
+
+inline dual exp(const dual& a) {
+  const double e = ::exp(a.v);
+  return dual(e, e*a.d);
+}
+inline dual sqrt(const dual& a) {
+  const double s = ::sqrt(a.v);
+  return dual(s, 0.5*a.d/s);
+}
+inline dual log(const dual& a) {
+  return dual(::log(a.v), a.d/a.v);
+}
+inline dual cos(const dual& a) {
+  return dual(::cos(a.v), -::sin(a.v)*a.d);
+}
+inline dual acos(const dual& a) {
+  return dual(::acos(a.v), -a.d/::sqrt(1.0 - a.v*a.v));
+}
+inline dual log10(const dual& a) {
+  return dual(::log10(a.v), a.d/(a.v*::log(10.0)));
+}
+inline dual sin(const dual& a) {
+  return dual(::sin(a.v), ::cos(a.v)*a.d);
+}
+inline dual tan(const dual& a) {
+  const double t = ::tan(a.v);
+  return dual(t, (1.0 + t*t)*a.d);
+}
+inline dual asin(const dual& a) {
+  return dual(::asin(a.v), a.d/::sqrt(1.0 - a.v*a.v));
+}
+inline dual atan(const dual& a) {
+  return dual(::atan(a.v), a.d/(1.0 + a.v*a.v));
+}
+inline dual tanh(const dual& a) {
+  const double t = ::tanh(a.v);
+  return dual(t, (1.0 - t*t)*a.d);
+}
+inline dual fabs(const dual& a) {
+  return a.v < 0 ? -a : a;
+}
+inline dual fmax(const dual& a, const dual& b) {
+  return a.v < b.v ? b : a;
+}
+inline dual fmin(const dual& a, const dual& b) {
+  return b.v < a.v ? b : a;
+}
+inline dual pow(const dual& a, const double b) {
+  if(b == 0.0) return dual(1.0);
+  return dual(::pow(a.v, b), b*::pow(a.v, b - 1.0)*a.d);
+}
+inline dual pow(const double a, const dual& b) {
+  const double p = ::pow(a, b.v);
+  return dual(p, b.d == 0.0 ? 0.0 : p*::log(a)*b.d);
+}
+inline dual pow(const dual& a, const dual& b) {
+  if(b.d == 0.0) return pow(a, b.v);
+  const double p = ::pow(a.v, b.v);
+  return dual(p, p*(b.d*::log(a.v) + b.v*a.d/a.v));
+}
+
+#endif
@@ -22,6 +22,14 @@
 #include <math.h>
 #include "mrgsolv.h"
 
+// Model variables are global to the model source file; give each thread
+// its own copy so individuals can be simulated in parallel
+#if __cplusplus >= 201103L
+#define MRGSOLVE_THREAD_LOCAL thread_local
+#else
+#define MRGSOLVE_THREAD_LOCAL __thread
+#endif
+
 typedef double local_double;
 typedef int    local_int;
 typedef bool   local_bool;
@@ -37,6 +45,9 @@ typedef bool   local_bool;
 #define pred_Q  _pred_[3]
 #define pred_V3 _pred_[4]
 #define pred_VP _pred_[4]
+#define pred_Q4 _pred_[5]
+#define pred_V4 _pred_[6]
+#define pred_VP2 _pred_[6]
 
 // advan/trans combinations
 // These definitions are added by mrgsolve at the end of $MAIN
@@ -49,6 +60,10 @@ typedef bool   local_bool;
 #define __ADVAN2_TRANS11__ pred_CL = CLi; pred_V  = Vi;  pred_KA = KAi;
 #define __ADVAN3_TRANS11__ pred_CL = CLi; pred_V2 = V1i; pred_Q =  Qi;  pred_V3 = V2i;
 #define __ADVAN4_TRANS11__ pred_CL = CLi; pred_V2 = V2i; pred_Q =  Qi;  pred_V3 = V3i; pred_KA = KAi;
+#define __ADVAN11_TRANS4__  pred_CL = CL;  pred_V2 = V1;  pred_Q = Q2;  pred_V3 = V2;  pred_Q4 = Q3;  pred_V4 = V3;
+#define __ADVAN12_TRANS4__  pred_CL = CL;  pred_V2 = V2;  pred_Q = Q3;  pred_V3 = V3;  pred_Q4 = Q4;  pred_V4 = V4; pred_KA = KA;
+#define __ADVAN11_TRANS11__ pred_CL = CLi; pred_V2 = V1i; pred_Q = Q2i; pred_V3 = V2i; pred_Q4 = Q3i; pred_V4 = V3i;
+#define __ADVAN12_TRANS11__ pred_CL = CLi; pred_V2 = V2i; pred_Q = Q3i; pred_V3 = V3i; pred_Q4 = Q4i; pred_V4 = V4i; pred_KA = KAi;
 
 // Don't need this?
 #define __BEGIN_pred__ extern "C" {void __ODEFUN___(MRGSOLVE_PRED_SIGNATURE) {
@@ -60,10 +75,22 @@ typedef bool   local_bool;
 #define __END_config__ __DONE__
 #define __BEGIN_ode__ extern "C" { void __ODEFUN___(MRGSOLVE_ODE_SIGNATURE) {
 #define __END_ode__ __DONE__
+#define __BEGIN_jac__ extern "C" { void __JACFUN___(MRGSOLVE_JAC_SIGNATURE) {
+#define __END_jac__ __DONE__
+#define __BEGIN_root__ extern "C" { void __ROOTFUN___(MRGSOLVE_ROOT_SIGNATURE) {
+#define __END_root__ __DONE__
+#define __BEGIN_vars__ extern "C" { void __VARSFUN___(MRGSOLVE_VARS_SIGNATURE) {
+#define __END_vars__ __DONE__
 #define __BEGIN_main__ extern "C" { void __INITFUN___(MRGSOLVE_INIT_SIGNATURE) {
 #define __END_main__ __DONE__
 #define __BEGIN_table__ extern "C" { void __TABLECODE___(MRGSOLVE_TABLE_SIGNATURE) {
 #define __END_table__ __DONE__
+#define __BEGIN_main_sens__ extern "C" { void __INITSENSFUN___(MRGSOLVE_INIT_SENS_SIGNATURE) {
+#define __END_main_sens__ __DONE__
+#define __BEGIN_ode_sens__ extern "C" { void __ODESENSFUN___(MRGSOLVE_ODE_SENS_SIGNATURE) {
+#define __END_ode_sens__ __DONE__
+#define __BEGIN_table_sens__ extern "C" { void __TABLESENSFUN___(MRGSOLVE_TABLE_SENS_SIGNATURE) {
+#define __END_table_sens__ __DONE__
 #define __DONE__ }}
 
 
@@ -121,6 +148,26 @@ typedef bool   local_bool;
 #define _STOP_ID_CF() (self.SYSTEMOFF=1);
 #define _STOP_ERROR() (self.SYSTEMOFF=9);
 
+// Jacobian element for $JAC: the derivative of dxdt_a with respect to b;
+// a and b are compartment names
+#define JAC(a,b) _JAC_[_JACIDX_##a + _nEQ*_JACIDX_##b]
+
+// Doubles from $MAIN: the count, then each one read into _V_[i] or, with 
+// _SET_, written back; a NULL _V_ only gets the count
+#define _NVARS_(n) _NV_ = n; if(_V_ == NULL) return;
+#define _MAINVAR_(i,x) if(_SET_) {x = _V_[i];} else {_V_[i] = x;}
+
+// The dual number copies of $MAIN, $ODE and $TABLE ($PLUGIN sens): the 
+// doubles from $MAIN come in _V_ and the ones from $ODE in _W_; the copy 
+// of $ODE gives their count and returns when _W_ is NULL.  Every other 
+// model variable gets a local copy so the real ones are left alone.
+#define _NSENSW_(n) _NW_ = n; if(_W_ == NULL) return;
+#define _SENSVAR_(x,v) dual& x = v; (void)x;
+#define _SENSLOCAL_(type,x) type x = ::x; (void)x;
+
+// Root function n (1-based) for $ROOT
+#define ROOT(n) _ROOT_[(n)-1]
+
 // Macro to insert dxdt_CMT = 0; for all compartments
 #define DXDTZERO() for(int _i_ = 0; _i_ < _nEQ; ++_i_) _DADT_[_i_] = 0;
 
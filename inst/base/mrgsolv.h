@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <iostream>
+#include "dual.h"
 
 typedef void (*refun)(void*);
 
@@ -100,8 +101,11 @@ public:
   void stop_id() {SYSTEMOFF=1;}
   void stop_id_cf(){SYSTEMOFF=2;}
   std::vector<mrgsolve::evdata> mevector;
+  int root; ///< the <code>$ROOT</code> function that crossed zero at this record (1-based); 0 otherwise
   void mevent(double time, int evid);
   double mtime(double time);
+  void mevent(const dual& time, int evid) {mevent(time.v, evid);} ///< for <code>$PLUGIN sens</code>
+  double mtime(const dual& time) {return mtime(time.v);} ///< for <code>$PLUGIN sens</code>
   double tad();
 }; 
 
@@ -120,8 +124,36 @@ typedef std::vector<double> dvec;
 #define MRGSOLVE_ODE_SIGNATURE const double* _ODETIME_, const double* _A_, double* _DADT_,  const dvec& _A_0_, const double* _THETA_
 #define MRGSOLVE_ODE_SIGNATURE_N 5
 
+//! signature for <code>$JAC</code>
+#define MRGSOLVE_JAC_SIGNATURE const double* _ODETIME_, const double* _A_, double* _JAC_,  const dvec& _A_0_, const double* _THETA_
+#define MRGSOLVE_JAC_SIGNATURE_N 5
+
+//! signature for <code>$ROOT</code>
+#define MRGSOLVE_ROOT_SIGNATURE const double* _ODETIME_, const double* _A_, double* _ROOT_,  const dvec& _A_0_, const double* _THETA_
+#define MRGSOLVE_ROOT_SIGNATURE_N 5
+
+//! signature for the function that gets and sets the doubles from <code>$MAIN</code>
+#define MRGSOLVE_VARS_SIGNATURE double* _V_, int& _NV_, const bool _SET_
+#define MRGSOLVE_VARS_SIGNATURE_N 3
+
 //! signature for <code>$PREAMBLE</code>
 #define MRGSOLVE_CONFIG_SIGNATURE databox& self, const double* _THETA_, const double neq, const double npar
 #define MRGSOLVE_CONFIG_SIGNATURE_N 4
 
+//! vector of dual numbers
+typedef std::vector<dual> dualvec;
+
+//! signature for the <code>dual</code> copy of <code>$MAIN</code> 
+//! (<code>$PLUGIN sens</code>)
+#define MRGSOLVE_INIT_SENS_SIGNATURE dualvec& _A_0_, const dual* _A_, const dual* _THETA_, dualvec& _F_, dualvec& _ALAG_, dualvec& _R_, dualvec& _D_, databox& self, dualvec& _pred_, mrgsolve::resim& simeta, dual* _V_
+#define MRGSOLVE_INIT_SENS_SIGNATURE_N 11
+
+//! signature for the <code>dual</code> copy of <code>$ODE</code>
+#define MRGSOLVE_ODE_SENS_SIGNATURE const double* _ODETIME_, const dual* _A_, dual* _DADT_, const dualvec& _A_0_, const dual* _THETA_, dual* _V_, dual* _W_, int& _NW_
+#define MRGSOLVE_ODE_SENS_SIGNATURE_N 8
+
+//! signature for the <code>dual</code> copy of <code>$TABLE</code>
+#define MRGSOLVE_TABLE_SENS_SIGNATURE const dual* _A_, const dualvec& _A_0_, const dual* _THETA_, const dualvec& _F_, const dualvec& _R_, databox& self, const dualvec& _pred_, dualvec& _capture_, mrgsolve::resim& simeps, dual* _V_, dual* _W_
+#define MRGSOLVE_TABLE_SENS_SIGNATURE_N 11
+
 #endif
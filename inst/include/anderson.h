@@ -0,0 +1,59 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file anderson.h
+ */
+
+#ifndef ANDERSON_H
+#define ANDERSON_H
+
+#include <vector>
+
+/**
+ * @brief Anderson acceleration for fixed-point iteration.
+ *
+ * For a map <code>x = g(x)</code>, each step takes the current input and
+ * its image and proposes the next input as the combination of the last
+ * few images that best cancels the (weighted) residuals
+ * <code>g(x) - x</code> (Walker and Ni, SIAM J Numer Anal 2011).  With no
+ * history the proposal is just <code>g(x)</code>, which is plain
+ * fixed-point iteration.
+ */
+class anderson {
+
+public:
+  anderson(const int n, const int m = 5);
+
+  void reset();
+  void step(std::vector<double>& x, const std::vector<double>& g,
+            const std::vector<double>& w);
+  int size() const {return Nhist;}
+
+private:
+  int N; ///< problem dimension
+  int M; ///< maximum number of differences kept
+  int Nhist; ///< number of differences kept now
+  int Next; ///< next column to write in the history
+  bool Have_last; ///< a previous step has been taken since the last reset
+  std::vector<double> Flast; ///< weighted residual from the last step
+  std::vector<double> Glast; ///< image from the last step
+  std::vector<double> dF; ///< residual differences; N by M, by column
+  std::vector<double> dG; ///< image differences; N by M, by column
+};
+
+#endif
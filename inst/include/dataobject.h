@@ -24,8 +24,6 @@
 #define DATAOBJECT_H
 
 #include <vector>
-#include <boost/shared_ptr.hpp>
-#include <boost/make_shared.hpp>
 #include "odeproblem.h"
 #include "RcppInclude.h"
 
@@ -63,10 +61,10 @@ public:
   void copy_inits(int this_row,odeproblem *prob);
   void reload_parameters(const Rcpp::NumericVector& param, odeproblem *prob);
   void idata_row();
-  unsigned int get_idata_row(const double ID);  
+  unsigned int get_idata_row(const double ID) const;  
   void locate_tran();
-  void get_records(recstack& a, int NID, int neq, unsigned int& obscount, unsigned int& evcount, bool obsonly,bool debug);
-  void get_records_pred(recstack& a, int NID, int neq, unsigned int& obscount, unsigned int& evcount, bool obsonly,bool debug);
+  void get_records(recstack& a, recpool& pool, int NID, int neq, unsigned int& obscount, unsigned int& evcount, bool obsonly,bool debug);
+  void get_records_pred(recstack& a, recpool& pool, int NID, int neq, unsigned int& obscount, unsigned int& evcount, bool obsonly,bool debug);
   void check_idcol(dataobject& data);
   double get_value(const int row, const int col) const {return Data(row,col);}
   double get_id_value(const int row) const {return Data(row,Idcol);}
@@ -21,15 +21,20 @@
 
 #ifndef DATARECORD_H
 #define DATARECORD_H
-#include <boost/shared_ptr.hpp>
+#include <vector>
 #include "mrgsolv.h"
 
 class odeproblem;
 class datarecord;
-typedef boost::shared_ptr<datarecord> rec_ptr;
+class recpool;
+class recheap;
+
+//! handle to a record; records are owned by a <code>recpool</code>
+typedef datarecord* rec_ptr;
 typedef std::vector<rec_ptr> reclist;
 
-#define NEWREC boost::make_shared<datarecord>
+#define __ALAG_POS -1200 ///< position for lagged doses, ahead of data set records
+#define __ROOT_POS -1300 ///< position for <code>$ROOT</code> events, ahead of lagged doses
 
 class datarecord {
   
@@ -47,7 +52,6 @@ public:
   //! short event constructor
   datarecord(short int cmt_, int evid_, double amt_, double time_, double rate_);
   
-  ~datarecord();
   
   double time() {return Time;}
   void time(double time_){Time = time_;}
@@ -86,10 +90,13 @@ public:
   void ii(double ii_){Ii = ii_;}
   double ii(){return Ii;}
   
-  void schedule(std::vector<rec_ptr>& thisi, double maxtime, bool put_ev_first, double Fn);
+  void schedule(recheap& thisi, recpool& pool, double maxtime, 
+                bool put_ev_first, double Fn, size_t ndata);
+  void schedule_next(recheap& thisi, recpool& pool, double maxtime);
   void implement(odeproblem* prob);
   void steady_infusion(odeproblem* prob);
   void steady_bolus(odeproblem* prob);
+  bool steady_analytic(odeproblem* prob, datarecord& evon, double duration);
   void steady(odeproblem* prob, double Fn);
   
   bool infusion(){return (Evid==1 || Evid==4 || Evid==5) && (Rate > 0);}
@@ -100,6 +107,8 @@ public:
   bool is_dose(){return Evid==1;}
   bool is_event_data() {return (Evid != 0) && (Evid != 2) && Fromdata;}
   bool needs_sorting(){return ((Addl > 0) || (Ss == 1));}
+  bool addl_pending() {return (Addl_k > 0) && (Addl_k < Addl);}
+  bool addl_dose() {return Addl_k > 0;}
   
   bool unarmed() {return !Armed;}
   void arm() {Armed=true;}
@@ -119,6 +128,8 @@ protected:
   bool Fromdata; ///< is this record from the original data set?
   short int Cmt; ///< record compartment number
   unsigned int Addl; ///< number of additional doses
+  unsigned int Addl_k; ///< for a scheduled additional dose, which one it is
+  double Addl_start; ///< for a scheduled additional dose, the original dose time
   unsigned short int Ss; ///< record steady-state indicator
   double Amt; ///< record dosing amount value
   double Rate; ///< record infusion rate value
@@ -128,6 +139,84 @@ protected:
 };
 
 
+/**
+ * @brief Arena for <code>datarecord</code> objects.
+ * 
+ * Records are constructed in large blocks of storage that are only 
+ * released when the pool is destroyed, so making a record is a pointer 
+ * bump and there is no per-record reference counting.  Handles returned by 
+ * <code>make</code> stay valid for the life of the pool, until the pool is 
+ * cleared or until the record is handed back with <code>release</code>; 
+ * released slots are reused by the next records that are made.  
+ * <code>datarecord</code> has no destructor to run, so records are never 
+ * destroyed one by one.  A pool must only be used by one thread at a time.
+ */
+class recpool {
+  
+public:
+  recpool(size_t block_size = 1024);
+  ~recpool();
+  
+  rec_ptr make(double time_, int pos_, bool output_);
+  rec_ptr make(double time_, short int cmt_, int pos_, double id_);
+  rec_ptr make(short int cmt_, int evid_, double amt_, double time_, 
+               double rate_, int pos_, double id_);
+  rec_ptr make(short int cmt_, int evid_, double amt_, double time_, 
+               double rate_);
+  rec_ptr make(const datarecord& rec);
+  
+  void release(rec_ptr rec) {Free.push_back(rec); --Count;}
+  void clear();
+  size_t size() const {return Count;}
+  
+private:
+  recpool(const recpool&);
+  recpool& operator=(const recpool&);
+  
+  void* slot();
+  
+  std::vector<datarecord*> Blocks; ///< storage blocks
+  std::vector<datarecord*> Free; ///< released slots
+  size_t Block_size; ///< number of records in each block
+  size_t Used; ///< number of records used in the last block
+  size_t Count; ///< number of records in use
+};
+
+/**
+ * @brief Queue of records that are scheduled during the simulation.
+ * 
+ * Additional doses, infusion ends, lagged doses and modeled events are 
+ * pushed here as they are created and come back out in the same order as 
+ * <code>CompRec</code> (time, then position); records that tie on both come 
+ * out in the order they were pushed.  Each push or pop is O(log n) in the 
+ * number of pending records, so the rest of the subject's records never 
+ * need to be sorted again.
+ */
+class recheap {
+  
+public:
+  recheap() : Count(0) {}
+  
+  void push(rec_ptr rec);
+  void pop();
+  rec_ptr top() const {return Heap.front().rec;}
+  bool empty() const {return Heap.empty();}
+  size_t size() const {return Heap.size();}
+  size_t count() const {return Count;}
+  void clear() {Heap.clear(); Count = 0;}
+  
+private:
+  struct entry {
+    rec_ptr rec;
+    size_t seq;
+  };
+  struct later {
+    bool operator()(const entry& a, const entry& b) const;
+  };
+  std::vector<entry> Heap; ///< pending records in heap order
+  size_t Count; ///< number of records pushed since the last clear
+};
+
 bool CompByTimePosRec(const rec_ptr& a, const rec_ptr& b);
 bool CompEqual(const reclist& a, double time, unsigned int evid, int cmt);
 
@@ -0,0 +1,94 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file dlsoda.h
+ */
+
+#ifndef DLSODA_H
+#define DLSODA_H
+
+#include <vector>
+#include <string>
+#include "integrator.h"
+
+/**
+ * @brief C++ implementation of the ODEPACK <code>DLSODA</code> solver.
+ *
+ * This is a line-by-line translation of <code>DLSODA</code> and the
+ * routines it calls for full (dense) Jacobians (<code>DSTODA</code>,
+ * <code>DPRJA</code>, <code>DSOLSY</code>, <code>DINTDY</code>,
+ * <code>DCFODE</code>, <code>DEWSET</code>, <code>DGEFA</code> and
+ * <code>DGESL</code>).  Everything the Fortran code kept in
+ * <code>COMMON /DLS001/</code>, <code>COMMON /DLSA01/</code> and the
+ * work arrays lives in the object, so different objects can be used
+ * on different threads at the same time.  Messages that
+ * <code>XERRWD</code> printed are saved in <code>messages</code> for the
+ * caller to deal with.
+ *
+ * Only scalar tolerances (<code>ITOL = 1</code>) and full Jacobians, 
+ * either user-supplied (<code>JT = 1</code>) or internally generated 
+ * (<code>JT = 2</code>), are supported.
+ */
+class dlsoda : public integrator {
+
+public:
+  dlsoda(int neq_);
+
+  void run(odepack_dlsoda* prob, double* y, double& t, const double& tout,
+           const double& rtol, const double& atol, const int itask,
+           int& istate, const int iopt, double* rwork, int* iwork,
+           const int jt);
+
+private:
+
+  void stoda(odepack_dlsoda* prob, double* y, const int jt);
+  void prja(odepack_dlsoda* prob, double* y);
+  void solsy(double* x);
+  int  intdy(const double t, const int k, double* dky);
+  void cfode(const int meth_);
+  void ewset(const double& rtol, const double& atol);
+  double mnorm(const double* v, const double* w) const;
+  double fnorm(const double* a, const double* w) const;
+  int  gefa(double* a, int* ipvt);
+  void gesl(const double* a, const int* ipvt, double* b);
+  void xerrwd(const std::string& msg, int ni, int i1, int i2,
+              int nr, double r1, double r2);
+
+  // COMMON /DLS001/
+  double conit, crate, el[14], elco[13][14], hold, rmax, tesco[13][4];
+  double ccmax, el0, h, hmin, hmxi, hu, rc, tn, uround;
+  int init, mxstep, mxhnil, nhnil, nslast, nyh;
+  int ialth, ipup, lmax, nqnyh, nslp;
+  int icf, ierpj, iersl, jcur, jstart, kflag, l;
+  int meth, miter, maxord, maxcor, msbp, mxncf, n, nq, nst, nfe, nje, nqu;
+
+  // COMMON /DLSA01/
+  double tsw, cm1[13], cm2[6], pdest, pdlast, ratio, pdnorm;
+  int ixpr, icount, irflag, jtyp, mused, mxordn, mxords;
+
+  // Work arrays
+  std::vector<double> yh; ///< Nordsieck history array; nyh by 13
+  std::vector<double> ewt; ///< error weights
+  std::vector<double> savf; ///< saved derivatives
+  std::vector<double> acor; ///< accumulated corrections
+  std::vector<double> wm; ///< iteration matrix and LU factors
+  std::vector<int> ipvt; ///< pivots for the LU factorization
+  double srur; ///< square root of unit roundoff
+};
+
+#endif
@@ -0,0 +1,243 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file integrator.h
+ */
+
+#ifndef INTEGRATOR_H
+#define INTEGRATOR_H
+
+#include <vector>
+#include <string>
+
+class odepack_dlsoda;
+
+//! solver codes for <code>odepack_dlsoda::solver</code>
+#define MRGSOLVE_SOLVER_LSODA 0
+#define MRGSOLVE_SOLVER_RK45 1
+#define MRGSOLVE_SOLVER_ROSENBROCK 2
+#define MRGSOLVE_SOLVER_EXPM 3
+
+/**
+ * @brief Interface for the ODE solvers used by <code>$ODE</code> models.
+ *
+ * Every solver is called the way <code>DLSODA</code> is: the same
+ * arguments, <code>istate = 1</code> to start and 2 to continue,
+ * <code>itask = 1</code> to step past <code>tout</code> and interpolate
+ * or <code>itask = 4</code> to do the same without stepping past the
+ * critical time in <code>rwork[0]</code>; <code>itask = 2</code> and 5
+ * take a single step instead.  A call with <code>itask = 1</code> and
+ * <code>tout</code> inside the last step only interpolates.  Optional
+ * inputs are read from <code>rwork</code> and <code>iwork</code> when
+ * <code>iopt = 1</code> (maximum step size in <code>rwork[5]</code> and
+ * maximum number of steps per call in <code>iwork[5]</code>).  On
+ * return, the number of steps, derivative evaluations and Jacobian
+ * evaluations since the last start are in <code>iwork[10]</code>,
+ * <code>iwork[11]</code> and <code>iwork[12]</code>, and the time the
+ * solver reached is in <code>rwork[12]</code>.
+ */
+class integrator {
+
+public:
+  integrator() : aborted(false) {}
+  virtual ~integrator() {}
+
+  virtual void run(odepack_dlsoda* prob, double* y, double& t,
+                   const double& tout, const double& rtol,
+                   const double& atol, const int itask, int& istate,
+                   const int iopt, double* rwork, int* iwork,
+                   const int jt) = 0;
+
+  std::vector<std::string> messages; ///< messages from the last call
+  bool aborted; ///< the last call was made with a negative istate
+};
+
+/**
+ * @brief Driver for one-step methods with error control and dense output.
+ *
+ * The driver takes steps from <code>Tn</code>, adjusting the step size to
+ * keep the local error estimate within the tolerances, until it reaches
+ * or passes <code>tout</code>; the solution at <code>tout</code> comes
+ * from the continuous extension of the last step.  Derived classes
+ * supply the method: one trial step, the continuous extension and the
+ * order that sets the step size exponent.
+ */
+class onestep : public integrator {
+
+public:
+  onestep(int neq_);
+
+  void run(odepack_dlsoda* prob, double* y, double& t,
+           const double& tout, const double& rtol, const double& atol,
+           const int itask, int& istate, const int iopt, double* rwork,
+           int* iwork, const int jt);
+
+protected:
+  virtual void start(odepack_dlsoda* /*prob*/) {}
+  virtual double attempt(odepack_dlsoda* prob, const double h,
+                         const double rtol, const double atol,
+                         const int jt) = 0;
+  virtual void accept() = 0;
+  virtual void interpolate(const double t, double* y) const = 0;
+  virtual int order() const = 0;
+
+  double initial_step(odepack_dlsoda* prob, const double rtol,
+                      const double atol, const double hmax,
+                      const double tdist);
+  double error_norm(const std::vector<double>& e, const double rtol,
+                    const double atol) const;
+
+  int N; ///< number of equations
+  double Tn; ///< time the solver has reached
+  double Told; ///< start of the last step
+  double H; ///< size of the next step
+  double Hu; ///< size of the last step
+  std::vector<double> Yn; ///< solution at <code>Tn</code>
+  std::vector<double> Fn; ///< derivatives at <code>Tn</code>
+  std::vector<double> Ynew; ///< solution at the end of the trial step
+  std::vector<double> Fnew; ///< derivatives at the end of the trial step
+  std::vector<double> Err; ///< error estimate for the trial step
+  int Nst; ///< steps since the last start
+  int Nfe; ///< derivative evaluations since the last start
+  int Nje; ///< Jacobian evaluations since the last start
+  bool Started; ///< the solver was started and didn't fail
+  bool Rejected; ///< the last trial step was rejected
+};
+
+/**
+ * @brief Dormand-Prince 5(4) explicit Runge-Kutta method.
+ *
+ * Seven stages with the last one reused as the first stage of the next
+ * step, a fourth-order error estimate and the fourth-order continuous
+ * extension from Hairer, Norsett and Wanner (<code>DOPRI5</code>).  For
+ * non-stiff models.
+ */
+class rk45 : public onestep {
+
+public:
+  rk45(int neq_);
+
+protected:
+  double attempt(odepack_dlsoda* prob, const double h, const double rtol,
+                 const double atol, const int jt);
+  void accept();
+  void interpolate(const double t, double* y) const;
+  int order() const {return 5;}
+
+private:
+  std::vector<double> K2, K3, K4, K5, K6; ///< stage derivatives
+  std::vector<double> Ytmp; ///< stage values
+  std::vector<double> Cont; ///< continuous extension coefficients; 5 by N
+};
+
+/**
+ * @brief Linearly implicit Rosenbrock 2(3) method.
+ *
+ * The L-stable method of Shampine and Reichelt (MATLAB
+ * <code>ode23s</code>) with a third-order error estimate and a
+ * second-order continuous extension.  The Jacobian comes from
+ * <code>$JAC</code> when the model has one (<code>jt = 1</code>) or from
+ * finite differences and is evaluated once per step.  For moderately stiff
+ * models.
+ */
+class rosenbrock : public onestep {
+
+public:
+  rosenbrock(int neq_);
+
+protected:
+  void start(odepack_dlsoda* prob);
+  double attempt(odepack_dlsoda* prob, const double h, const double rtol,
+                 const double atol, const int jt);
+  void accept();
+  void interpolate(const double t, double* y) const;
+  int order() const {return 3;}
+
+private:
+  void jacobian(odepack_dlsoda* prob, const double rtol, const double atol,
+                const int jt);
+  bool factor();
+  void solve(double* b) const;
+
+  std::vector<double> J; ///< Jacobian at <code>Tn</code>; column-major
+  std::vector<double> Dfdt; ///< time derivative of the derivatives
+  std::vector<double> W; ///< iteration matrix and its LU factors
+  std::vector<int> Piv; ///< pivots for <code>W</code>
+  std::vector<double> K1, K2, K3, F1; ///< stages
+  std::vector<double> Ytmp; ///< stage values
+  std::vector<double> Y0, D1, D2; ///< continuous extension for the last step
+  bool Jcur; ///< <code>J</code> is current for <code>Tn</code>
+};
+
+/**
+ * @brief Exact solution of linear models with the matrix exponential.
+ *
+ * For models where the derivatives are <code>K y + b</code> with
+ * <code>K</code> and <code>b</code> constant between records (linear
+ * transfer between compartments; zero-order inputs in <code>b</code>), the
+ * solution at <code>t + h</code> is <code>exp(K h) y + G(h) b</code> where
+ * <code>G(h)</code> is the integral of <code>exp(K s)</code> from 0 to
+ * <code>h</code>.  <code>K</code> and <code>b</code> are found from
+ * <code>N+1</code> derivative evaluations at the start of each call and
+ * the model is checked against them at the current amounts, at a second
+ * point away from them and where the call ends; a model that isn't
+ * linear is an error.  The two matrices are cached for the last few
+ * step sizes and reused as long as <code>K</code> doesn't change, so a
+ * regular output grid costs a matrix exponential per subject.  Each call
+ * reaches <code>tout</code> in a single step unless a maximum step size
+ * is set; <code>iwork[12]</code> counts matrix exponentials.
+ */
+class linear : public integrator {
+
+public:
+  linear(int neq_);
+
+  void run(odepack_dlsoda* prob, double* y, double& t,
+           const double& tout, const double& rtol, const double& atol,
+           const int itask, int& istate, const int iopt, double* rwork,
+           int* iwork, const int jt);
+
+private:
+  bool rate_matrix(odepack_dlsoda* prob);
+  bool fits(odepack_dlsoda* prob, double* y);
+  void nonlinear(double* y, double& t, int& istate);
+  void propagate(const double h, const double* y0, double* y);
+  void exponential(const double h, double* phi, double* gam);
+
+  int N; ///< number of equations
+  double Tn; ///< time the solver has reached
+  double Told; ///< start of the last step
+  double Hu; ///< size of the last step
+  std::vector<double> Yn; ///< solution at <code>Tn</code>
+  std::vector<double> Y0; ///< solution at <code>Told</code>
+  std::vector<double> K; ///< rate matrix; column-major
+  std::vector<double> B; ///< derivatives at zero amounts
+  std::vector<double> Ytmp, Ftmp; ///< scratch
+  std::vector<double> Kc; ///< rate matrix the cache was computed for
+  std::vector<double> Cache_h; ///< step sizes in the cache
+  std::vector<std::vector<double> > Cache; ///< <code>exp(K h)</code> then <code>G(h)</code>
+  int Cache_next; ///< cache slot to replace next
+  std::vector<double> A, X, P, Q, T; ///< matrix exponential scratch; 2N by 2N
+  std::vector<int> Piv; ///< pivots for <code>Q</code>
+  int Nst; ///< steps since the last start
+  int Nfe; ///< derivative evaluations since the last start
+  int Nexp; ///< matrix exponentials since the last start
+  bool Started; ///< the solver was started and didn't fail
+};
+
+#endif
@@ -0,0 +1,56 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file mvgauss.h
+ */
+
+#ifndef MVGAUSS_H
+#define MVGAUSS_H
+
+#include <vector>
+#include "RcppInclude.h"
+
+/**
+ * @brief Factored variance/covariance matrix for multivariate normal draws.
+ *
+ * The matrix is split into independent blocks (groups of rows that have
+ * no covariance with rows in any other group), and each block is factored
+ * once when the matrix is set.  Matrices built by <code>SUPERMATRIX</code>
+ * from many small <code>$OMEGA</code> blocks are therefore never
+ * decomposed or multiplied as one dense matrix.  Uncorrelated elements
+ * get a 1 by 1 block and are simply scaled.
+ */
+class mvgauss {
+
+public:
+  mvgauss() : N(0) {}
+  mvgauss(const arma::mat& x);
+
+  void set(const arma::mat& x);
+  arma::mat draw(const int n) const;
+  void apply(const double* z, double* x) const;
+  unsigned int size() const {return N;}
+  unsigned int nblock() const {return Factor.size();}
+
+private:
+  unsigned int N; ///< matrix dimension
+  std::vector<std::vector<unsigned int> > Index; ///< rows and columns in each block
+  std::vector<arma::mat> Factor; ///< square root of each block
+};
+
+#endif
@@ -24,6 +24,7 @@
 #ifndef ODEPACK_DLSODA_H
 #define ODEPACK_DLSODA_H
 #include <math.h>
+#include "integrator.h"
 
 class odepack_dlsoda {
 
@@ -56,24 +57,44 @@ public:
   
   int     npar() {return Npar;}
   int     neq(){return Neq;}
+  int     nsys() const {return Nsys;}
+  void    nsys(int n);
+  int     jt(){return xjt;}
+  
+  void    solver(int type);
+  int     solver(){return Solver_type;}
+  double  nstep(){return Nstep;}
+  double  nrhs(){return Nrhs;}
+  double  njac(){return Njac;}
+  
+  virtual void call_derivs(int *neq, double *t, double *y, double *ydot) = 0;
+  virtual void call_jac(int* /*neq*/, double* /*t*/, double* /*y*/,
+                        double* /*pd*/) {}
   
 protected :
-
-  int     xliwork; ///< length of iwork array
-  int     xlrwork; ///< length of rwork array
+  
+  void integrate(double& tfrom, const double& tto);
+  void make_solver();
+  
+  integrator* Solver; ///< the ODE solver
+  int     Solver_type; ///< solver code; see integrator.h
+  double  Nstep; ///< solver steps taken in this run
+  double  Nrhs; ///< derivative evaluations in this run
+  double  Njac; ///< Jacobian evaluations in this run
   int     xistate; ///< istate value
   int     xitask; ///< itask value
   int     xiopt; ///< iopt value
   int     xitol; ///< itol value
   int     Neq; ///< number of state variables
+  int     Nsys; ///< number of equations the solver integrates; at least <code>Neq</code>
   int     Npar; ///< number of model parameters
   int     xjt; ///< jacobian indicator
   double  xatol; ///< absolute tolerance
   double  xrtol; ///< relative tolerance
   double* xrwork; ///< rwork array
   int*    xiwork; ///< iwork array
-  double* Y;  ///< current value of state variables
-  double* Ydot; ///< current value of ODEs
+  double* Y;  ///< current value of state variables; <code>Nsys</code> values
+  double* Ydot; ///< current value of ODEs; <code>Nsys</code> values
 };
 
 
@@ -24,8 +24,14 @@
 #define ODEPROBLEM_H
 #include <math.h>
 #include <vector>
+#include <string>
+#include <map>
+#include <stdexcept>
 #include "RcppInclude.h"
 #include "odepack_dlsoda.h"
+#include "philox.h"
+#include "mvgauss.h"
+#include "dual.h"
 #include "mrgsolv.h"
 #include "datarecord.h"
 
@@ -36,6 +42,18 @@
 
 class odeproblem;
 
+/**
+ * @brief Error raised by the simulation engine.
+ * 
+ * Unlike <code>Rcpp::exception</code>, constructing this object doesn't 
+ * call into R, so it can be thrown while simulating on a worker thread. 
+ * The caller forwards the message to R once it is back on the main thread.
+ */
+class mrgsolve_error : public std::runtime_error {
+public:
+  mrgsolve_error(const std::string& msg) : std::runtime_error(msg) {}
+};
+
 //! vector of <code>datarecord</code> objects for one <code>ID</code>
 typedef std::vector<rec_ptr> reclist;
 
@@ -51,24 +69,42 @@ typedef void (*table_func)(MRGSOLVE_TABLE_SIGNATURE);
 //! <code>$ODE</code> function
 typedef void (*deriv_func)(MRGSOLVE_ODE_SIGNATURE);
 
+//! <code>$JAC</code> function
+typedef void (*jac_func)(MRGSOLVE_JAC_SIGNATURE);
+
+//! <code>$ROOT</code> function
+typedef void (*root_func)(MRGSOLVE_ROOT_SIGNATURE);
+
+//! gets and sets the doubles from <code>$MAIN</code>
+typedef void (*vars_func)(MRGSOLVE_VARS_SIGNATURE);
+
+//! <code>dual</code> copy of <code>$MAIN</code>
+typedef void (*init_sens_func)(MRGSOLVE_INIT_SENS_SIGNATURE);
+
+//! <code>dual</code> copy of <code>$ODE</code>
+typedef void (*deriv_sens_func)(MRGSOLVE_ODE_SENS_SIGNATURE);
+
+//! <code>dual</code> copy of <code>$TABLE</code>
+typedef void (*table_sens_func)(MRGSOLVE_TABLE_SENS_SIGNATURE);
+
 //! <code>$PREAMBLE</code> function
 typedef void (*config_func)(MRGSOLVE_CONFIG_SIGNATURE);
 
-//! function to hand off to <code>DLSODA</code>
-typedef void main_deriv_func(int* neq, double* t,double* y,double* ydot,odeproblem* prob);
-
 #define MRGSOLVE_GET_PRED_CL  (pred[0]) ///< map CL to pred position 0 for <code>$PKMODEL</code>
 #define MRGSOLVE_GET_PRED_VC  (pred[1]) ///< map VC to pred position 1 for <code>$PKMODEL</code>
 #define MRGSOLVE_GET_PRED_KA  (pred[2]) ///< map KA to pred position 2 for <code>$PKMODEL</code>
 #define MRGSOLVE_GET_PRED_Q   (pred[3]) ///< map Q to pred position 3 for <code>$PKMODEL</code>
 #define MRGSOLVE_GET_PRED_VP  (pred[4]) ///< map VP to pred position 4 for <code>$PKMODEL</code>
+#define MRGSOLVE_GET_PRED_Q4  (pred[5]) ///< map Q4 (second peripheral) to pred position 5 for <code>$PKMODEL</code>
+#define MRGSOLVE_GET_PRED_VP2 (pred[6]) ///< map VP2 (second peripheral) to pred position 6 for <code>$PKMODEL</code>
 #define MRGSOLVE_GET_PRED_K10 (pred[0]/pred[1]) ///< rate constants for <code>$PKMODEL</code>
 #define MRGSOLVE_GET_PRED_K12 (pred[3]/pred[1]) ///< rate constants for <code>$PKMODEL</code>
 #define MRGSOLVE_GET_PRED_K21 (pred[3]/pred[4]) ///< rate constants for <code>$PKMODEL</code>
+#define MRGSOLVE_GET_PRED_K13 (pred[5]/pred[1]) ///< rate constants for <code>$PKMODEL</code>
+#define MRGSOLVE_GET_PRED_K31 (pred[5]/pred[6]) ///< rate constants for <code>$PKMODEL</code>
 
 extern "C"{DL_FUNC tofunptr(SEXP a);}
 
-main_deriv_func main_derivs;
 void neg_istate(int istate);
 
 template<typename T,typename type2> void tofunptr(T b, type2 a) {
@@ -78,6 +114,67 @@ template<typename T,typename type2> void tofunptr(T b, type2 a) {
 void dosimeta(void*);
 void dosimeps(void*);
 
+/**
+ * @brief Outcome of bringing the system to steady state on one record.
+ */
+struct ssinfo {
+  unsigned int idn; ///< subject index
+  double id; ///< subject ID
+  double time; ///< record time
+  int cmt; ///< record compartment
+  int iter; ///< dosing intervals simulated; 0 when solved in closed form
+  bool converged; ///< steady state was reached within the tolerances
+  bool cached; ///< the result was replayed from the steady state cache
+};
+
+/**
+ * @brief A steady state result saved for replay.
+ * 
+ * The state is the one reached before any lag time or <code>ss=2</code> 
+ * handling; <code>tfrom</code> and <code>tto</code> are the bounds of the 
+ * last dosing interval that was simulated.
+ */
+struct sscache {
+  dvec y; ///< the steady state amounts, then their sensitivities
+  double tfrom; ///< start of the last interval
+  double tto; ///< end of the last interval
+  int iter; ///< dosing intervals simulated
+  bool converged; ///< steady state was reached within the tolerances
+};
+
+/**
+ * @brief The state of one subject, saved so that it can be picked up again.
+ * 
+ * Everything that carries from one record to the next: the amounts (and 
+ * their sensitivities), parameters, active infusions, the settings from 
+ * <code>$MAIN</code>, compartment status and the data that goes to the 
+ * model functions.  Solver history isn't part of the state; the solver 
+ * starts again from the saved amounts.
+ */
+struct odestate {
+  dvec y; ///< amounts, then their sensitivities
+  dvec param; ///< model parameters
+  dvec r0; ///< current infusion rates
+  std::vector<unsigned int> infusion_count; ///< number of active infusions
+  dvec r; ///< infusion rates from <code>$MAIN</code>
+  dvec dur; ///< infusion durations from <code>$MAIN</code>
+  dvec f; ///< bioavailability
+  dvec alag; ///< dosing lag times
+  std::vector<int> on; ///< compartment on/off indicator
+  dvec init; ///< initial conditions
+  dvec pred; ///< <code>$PKMODEL</code> parameters
+  dvec vars; ///< doubles from <code>$MAIN</code>
+  dvec dsens; ///< derivatives of the initial conditions, <code>pred</code> and the doubles from <code>$MAIN</code> for sensitivities
+  databox d; ///< data passed to the model functions
+  unsigned int resim_eta; ///< number of <code>simeta()</code> calls
+  unsigned int resim_eps; ///< number of <code>simeps()</code> calls
+};
+
+//! order <code>ssinfo</code> by subject index
+inline bool CompSsinfo(const ssinfo& a, const ssinfo& b) {
+  return a.idn < b.idn;
+}
+
 class odeproblem : public odepack_dlsoda {
 
 public:
@@ -88,7 +185,14 @@ public:
   
   void do_init_calc(bool answer) {Do_Init_Calc = answer;}
   void advance(double tfrom, double tto);
+  void tstop(const double t) {Tstop = t; Use_tstop = true;}
+  void watch_roots() {Use_roots = true;}
+  int root_found() const {return Root_found;}
+  double root_time() const {return Root_time;}
+  void root_fired(const int k) {d.root = k;}
+  void warm_check(const double tfrom);
   void call_derivs(int *neq, double *t, double *y, double *ydot);
+  void call_jac(int *neq, double *t, double *y, double *pd);
   void init(int pos, double value){Init_value[pos] = value;}
   double init(int pos){return Init_value[pos];}
   
@@ -97,9 +201,11 @@ public:
 
   void y_init(int pos, double value);
   void y_init(Rcpp::NumericVector x);
+  void y_init(const dvec& x);
   void y_add(const unsigned int pos, const double& value);
   
   void table_call();
+  void table_call_sens();
   void table_init_call();
   void config_call();
   
@@ -109,7 +215,16 @@ public:
   void sigma(Rcpp::NumericMatrix& x);
   
   arma::mat mv_omega(int n);
-  arma::mat mv_sigma(int n);
+  
+  void stream_seed(const int seed, const bool eta, const bool eps);
+  bool streaming() const {return Streaming;}
+  bool streaming_eps() const {return Stream_eps;}
+  void stream_eta();
+  void stream_replicate(const unsigned int rep) {Rng.replicate(rep);}
+  void draw_eps(const unsigned int record, const unsigned int row);
+  void stream_simeta();
+  void stream_simeps();
+  void r_simeps();
 
   void pass_envir(Rcpp::Environment* x){d.envir=reinterpret_cast<void*>(x);};
   
@@ -134,6 +249,9 @@ public:
   double dur(unsigned int pos){return D[pos];}
   
   void reset_newid(const double id_);
+  void reset_run();
+  void save(odestate& state) const;
+  void restore(const odestate& state);
   
   void eta(int pos, double value) {d.ETA[pos] = value;}
   void eps(int pos, double value) {d.EPS[pos] = value;}
@@ -156,6 +274,9 @@ public:
   int  advan(){return Advan;}
   void advan2(const double& tfrom, const double& tto);
   void advan4(const double& tfrom, const double& tto);
+  void advan12(const double& tfrom, const double& tto);
+  void advan_sens(const double dt);
+  void advan_pk(const double* k, const double dt);
   
   void neta(int n);
   void neps(int n);
@@ -165,11 +286,41 @@ public:
   void idn(int n) {d.idn = n;}
   void rown(int n) {d.rown=n;}
   
+  void threaded(bool x) {Threaded = x;}
+  bool threaded() const {return Threaded;}
+  
   dvec& get_capture() {return Capture;}
   double capture(int i) {return Capture[i];}
   
+  int nsens() const {return Nsens;}
+  double sens_y(const int pos, const int k) const {return Y[Neq*(k+1) + pos];}
+  double sens_capture(const int pos, const int k) const {
+    return Sens_capture[k*Capture.size() + pos];
+  }
+  void sens_clear(const int pos);
+  
   void copy_parin(const Rcpp::List& parin);
   void copy_funs(const Rcpp::List& funs);
+  void copy_jac(const Rcpp::List& funs);
+  void copy_root(const Rcpp::List& funs);
+  void copy_vars(const Rcpp::List& funs);
+  void copy_sens_funs(const Rcpp::List& funs);
+  void copy_sens(const Rcpp::IntegerVector& sens);
+  
+  int ss_n() const {return Ss_n;}
+  double ss_rtol() const {return Ss_rtol;}
+  double ss_atol() const {return Ss_atol;}
+  void ss_log(const double time, const int cmt, const int iter, 
+              const bool converged, const bool cached);
+  const std::vector<ssinfo>& ss_results() const {return Ss_log;}
+  unsigned int ss_fail() const {return Ss_fail;}
+  bool ss_cache_key(dvec& key, rec_ptr rec, const double duration);
+  bool ss_cache_get(const dvec& key, double& tfrom, double& tto, int& iter, 
+                    bool& converged);
+  void ss_cache_put(const dvec& key, const double tfrom, const double tto, 
+                    const int iter, const bool converged);
+  unsigned int ss_hits() const {return Ss_hits;}
+  unsigned int ss_misses() const {return Ss_misses;}
   
   bool any_mtime() {return d.mevector.size() > 0;}
   std::vector<mrgsolve::evdata> mtimes(){return d.mevector;}
@@ -188,27 +339,128 @@ protected:
   std::vector<double> Alag; ///< dosing lag time
 
   std::vector<int> On; ///< compartment on/off indicator
+  
+  double Tstop; ///< the solver must not step past this time
+  bool Use_tstop; ///< <code>Tstop</code> applies to the next advance
+  double Warm_t; ///< time where the solver stopped
+  dvec Warm_y; ///< amounts where the solver stopped
+  dvec Warm_dxdt; ///< scratch space for checking the derivatives
+  dvec Warm_param; ///< parameters for the last solver call
+  dvec Warm_vars; ///< doubles from <code>$MAIN</code> for the last solver call
+  dvec Warm_v; ///< scratch space for checking the doubles from <code>$MAIN</code>
+  
+  void solver_check();
+  void integrate_roots(const double tfrom, double& tend);
+  void root_call(double t, double* y, double* g);
+  void root_interp(const double t, double* y);
+  int root_flip(const dvec& g) const;
+  double root_locate(double tlo, double thi);
+  
+  int Nroot; ///< number of <code>$ROOT</code> functions
+  bool Use_roots; ///< watch the root functions on the next advance
+  int Root_found; ///< root crossed on the last advance (1-based); 0 for none
+  double Root_time; ///< where the root was crossed
+  dvec Root_lo; ///< root functions at the start of the bracket
+  dvec Root_hi; ///< root functions at the end of the bracket
+  dvec Root_mid; ///< root functions inside the bracket
+  dvec Root_y; ///< amounts inside the bracket
+  std::vector<int> Root_sign; ///< sign of each root function at the start; 0 until it is nonzero
+  
+  void jac_diff(double* t, double* y, double* pd);
+  void main_call(dvec& init);
+  void main_sens();
+  void sens_point(const int k, const double* y);
+  
+  int Nsens; ///< number of parameters with sensitivities
+  std::vector<int> Sens_par; ///< parameters with sensitivities (C++ indexing)
+  dvec Sens_y; ///< perturbed amounts for <code>jac_diff</code>
+  dvec Sens_f0; ///< derivatives at the amounts for <code>jac_diff</code>
+  dvec Sens_jac; ///< Jacobian of the state variables
+  dvec Sens_capture; ///< sensitivities of the captured items; one column per parameter
+  std::vector<dual> Sens_theta; ///< parameters, with a derivative of one for the sensitivity parameter
+  std::vector<dual> Sens_amt; ///< amounts and their sensitivities to one parameter
+  std::vector<dual> Sens_dadt; ///< derivatives from the copy of <code>$ODE</code>
+  std::vector<dual> Sens_init; ///< initial conditions and their derivatives
+  dvec Sens_dinit; ///< derivatives of the initial conditions; one column per parameter
+  dvec Sens_i0; ///< initial conditions going into the last <code>$MAIN</code> call
+  std::vector<dual> Sens_a0; ///< initial conditions for the copy of <code>$MAIN</code>
+  dvec Sens_da0; ///< derivatives of the initial conditions from the last <code>$MAIN</code> call; one column per parameter
+  std::vector<dual> Sens_F; ///< bioavailability for the copies of <code>$MAIN</code> and <code>$TABLE</code>; doses are fixed
+  std::vector<dual> Sens_alag; ///< lag times for the copy of <code>$MAIN</code>
+  std::vector<dual> Sens_R; ///< infusion rates for the copies of <code>$MAIN</code> and <code>$TABLE</code>
+  std::vector<dual> Sens_D; ///< infusion durations for the copy of <code>$MAIN</code>
+  dvec Sens_p0; ///< <code>pred</code> going into the last <code>$MAIN</code> call
+  std::vector<dual> Sens_pred; ///< <code>pred</code> and its derivatives
+  dvec Sens_dpred; ///< derivatives of <code>pred</code>; one column per parameter
+  std::vector<dual> Sens_cap; ///< captured items from the copy of <code>$TABLE</code>
+  databox Sens_self; ///< <code>self</code> for the copies of <code>$MAIN</code> and <code>$TABLE</code>
+  int Nvars; ///< number of doubles from <code>$MAIN</code>
+  dvec Sens_v0; ///< doubles from <code>$MAIN</code> going into the last call
+  std::vector<dual> Sens_v; ///< doubles from <code>$MAIN</code> and their derivatives
+  dvec Sens_dvars; ///< derivatives of the doubles from <code>$MAIN</code>; one column per parameter
+  int Nsensw; ///< number of doubles from <code>$ODE</code>
+  std::vector<dual> Sens_w; ///< doubles from <code>$ODE</code> and their derivatives
+  mrgsolve::resim Sens_simeta; ///< <code>simeta()</code> and <code>simeps()</code> for the copies; does nothing
+  std::vector<dual> Sens_state; ///< amounts and sensitivities for <code>$PKMODEL</code>
+  std::vector<dual> Sens_pk; ///< <code>pred</code> and its derivatives
+  std::vector<dual> Sens_a; ///< used for advan 1/2/3/4/11/12 sensitivities
+  std::vector<dual> Sens_alpha; ///< used for advan 1/2/3/4/11/12 sensitivities
+  
   databox d; ///< various data passed to model functions
   
-  int Advan;  ///< simulation mode: 1/2/3/4 (PK models) or 13 (odes)
-  std::vector<double> a;     ///< used for advan 1/2/3/4 calculations
-  std::vector<double> alpha; ///< used for advan 1/2/3/4 calculation
+  int Advan;  ///< simulation mode: 1/2/3/4/11/12 (PK models) or 13 (odes)
+  std::vector<double> a;     ///< used for advan 1/2/3/4/11/12 calculations
+  std::vector<double> alpha; ///< used for advan 1/2/3/4/11/12 calculation
+  dvec Pk_key; ///< rate constants for the cached advan 1/2/3/4/11/12 solutions
+  dvec Pk_dt; ///< time steps in the cache
+  std::vector<dvec> Pk_mat; ///< solution matrices for each time step; see <code>advan_pk</code>
+  dvec Pk_y; ///< starting amounts for <code>advan_pk</code>
+  int Pk_next; ///< cache slot to replace next
   
   mrgsolve::resim simeta;  ///< functor for resimulating etas
   mrgsolve::resim simeps; ///< functor for resimulating epsilons
 
-  arma::mat Omega; ///< variance/covariance matrix for between-subject variability
-  arma::mat Sigma; ///< variance/covariance matrix for within-subject variability
+  mvgauss Omega; ///< variance/covariance matrix for between-subject variability
+  mvgauss Sigma; ///< variance/covariance matrix for within-subject variability
+  
+  void stream_draw(const mvgauss& mv, dvec& x, const uint32_t stream,
+                   const uint32_t record);
+  
+  bool Streaming; ///< draw ETA from per-subject random streams
+  bool Stream_eps; ///< draw EPS from per-subject random streams
+  long Eps_row; ///< the last output row EPS were drawn for with the R generator
+  philox Rng; ///< counter-based random number generator for streams
+  dvec Stream_z; ///< standard normal deviates for stream draws
+  unsigned int Resim_eta; ///< number of <code>simeta()</code> calls for this subject
+  unsigned int Resim_eps; ///< number of <code>simeps()</code> calls for this subject
     
   std::vector<double> pred; ///< brings clearances, volumes, and & for advan 1/2/3/4
   std::vector<double> Capture; ///< captured data items
   
   deriv_func Derivs; ///< <code>$ODE</code> function
+  jac_func Jac; ///< <code>$JAC</code> function; <code>NULL</code> if there is none
+  root_func Root; ///< <code>$ROOT</code> function; <code>NULL</code> if there is none
+  vars_func Vars; ///< gets and sets the doubles from <code>$MAIN</code>; <code>NULL</code> for models built by older versions
   init_func Inits; ///< <code>$MAIN</code> function
   table_func Table; ///< <code>$TABLE</code> function
   config_func Config; ///< <code>$PREAMBLE</code> function
+  init_sens_func InitsSens; ///< <code>dual</code> copy of <code>$MAIN</code>; <code>NULL</code> without <code>$PLUGIN sens</code>
+  deriv_sens_func DerivsSens; ///< <code>dual</code> copy of <code>$ODE</code>
+  table_sens_func TableSens; ///< <code>dual</code> copy of <code>$TABLE</code>
   
   bool Do_Init_Calc;
+  bool Threaded; ///< simulating on a worker thread
+  
+  int Ss_n; ///< maximum number of dosing intervals to reach steady state
+  double Ss_rtol; ///< relative tolerance for steady state
+  double Ss_atol; ///< absolute tolerance for steady state
+  bool Ss_report; ///< keep an <code>ssinfo</code> for every steady state record
+  unsigned int Ss_fail; ///< number of records that didn't reach steady state
+  std::vector<ssinfo> Ss_log; ///< steady state outcomes
+  bool Ss_cache; ///< save and replay steady state results
+  std::map<dvec,sscache> Ss_saved; ///< steady state results, by inputs
+  unsigned int Ss_hits; ///< steady state results replayed from the cache
+  unsigned int Ss_misses; ///< steady state results computed and saved
   
 };
 
@@ -0,0 +1,61 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file philox.h
+ */
+
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <stdint.h>
+
+/**
+ * @brief Counter-based random number generator.
+ *
+ * Philox4x32-10 (Salmon et al., SC11).  Each block of random bits is a
+ * pure function of the key and the counter, so the numbers drawn for a
+ * given (seed, subject, stream, record) are the same no matter which
+ * other subjects or records were simulated before, or on which thread.
+ *
+ * The key holds the seed and the replicate number.  The counter holds the subject ID, the
+ * record number and, in the top bits of the last word, the stream
+ * number; the rest of the last word counts the blocks drawn since
+ * <code>philox::set</code> was called.
+ */
+class philox {
+
+public:
+  philox();
+  philox(const uint32_t seed);
+
+  void seed(const uint32_t seed);
+  void replicate(const uint32_t rep);
+  void set(const double id, const uint32_t stream, const uint32_t record);
+  double rnorm();
+
+private:
+  void next_block();
+
+  uint32_t Key[2]; ///< generator key
+  uint32_t Ctr[4]; ///< counter for the next block
+  uint32_t Out[4]; ///< the current block
+  double Norm[2]; ///< pending standard normal deviates
+  int Nnorm; ///< number of pending deviates in <code>Norm</code>
+};
+
+#endif
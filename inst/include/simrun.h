@@ -0,0 +1,140 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file simrun.h
+ *
+ */
+
+#ifndef SIMRUN_H
+#define SIMRUN_H
+
+#include <vector>
+#include <string>
+#include "RcppInclude.h"
+#include "odeproblem.h"
+#include "dataobject.h"
+
+/**
+ * @brief A subject saved part way through a simulation.
+ *
+ * <code>simrun::id</code> fills in a checkpoint when it gets to the first
+ * record at or after <code>time</code>.  The subject can then be picked up
+ * from the checkpoint any number of times with different records from 
+ * that time on; see <code>simrun::branch</code>.  Records that were 
+ * scheduled before the checkpoint (additional doses, infusion ends, lagged
+ * doses and modeled events) are kept as copies and go back on the queue 
+ * for every branch.
+ */
+struct checkpoint {
+  checkpoint() : time(0.0), saved(false), tfrom(0.0), told(-1.0), 
+                 last(0.0), rows(0) {}
+  double time; ///< records at or after this time are left for the branches
+  bool saved; ///< the state was saved
+  double tfrom; ///< time the system was advanced to
+  double told; ///< time of the last dose, for time after dose
+  double last; ///< time of the last data set record before <code>time</code>
+  unsigned int rows; ///< output rows written before the checkpoint
+  odestate state; ///< state of the <code>odeproblem</code>
+  std::vector<datarecord> pending; ///< scheduled records, in the order they come due
+  std::vector<datarecord> modeled; ///< modeled events, for finding duplicates
+};
+
+/**
+ * @brief Per-subject simulation engine.
+ *
+ * A <code>simrun</code> object holds everything that is shared by all
+ * subjects in a simulation run: the data objects, run settings, the
+ * output matrix and the output layout.  Individual subjects are
+ * simulated with <code>simrun::id</code>, which only touches the
+ * <code>odeproblem</code> it is handed, the records for that subject and
+ * the output rows belonging to that subject.  Different subjects can
+ * therefore be simulated on different threads, each with its own
+ * <code>odeproblem</code> object.
+ *
+ */
+class simrun {
+
+public:
+  simrun(dataobject* dat_, dataobject* idat_, Rcpp::NumericMatrix& ans_);
+  ~simrun();
+
+  void id(const size_t i, reclist& recs, odeproblem* prob, unsigned int crow,
+          recpool& pool, const size_t rep = 0, checkpoint* save = NULL,
+          const checkpoint* from = NULL, dataobject* data = NULL);
+  void run(recstack& a, std::vector<odeproblem*>& probs,
+           std::vector<checkpoint>* save = NULL);
+  void sweep(recstack& a, std::vector<odeproblem*>& probs,
+             const Rcpp::NumericMatrix& param, const unsigned int nrow);
+  void branch(const std::vector<checkpoint>& from, 
+              std::vector<recstack>& branches, 
+              std::vector<dataobject>& data, 
+              std::vector<odeproblem*>& probs,
+              const std::vector<unsigned int>& rows);
+
+  void output(Rcpp::NumericMatrix& ans_);
+  void capture(const Rcpp::IntegerVector& capture_, unsigned int start);
+  void request(const Rcpp::IntegerVector& request_, unsigned int start);
+  void sens(const unsigned int nsens_, unsigned int start);
+  void first_rows(const recstack& a);
+
+  bool tad; ///< calculate time after dose
+  bool nocb; ///< next observation carry backward
+  bool filbak; ///< fill data items backward from the first record
+  bool addl_ev_first; ///< put addl doses before observations at same time
+  double mindt; ///< time step below which the system isn't advanced
+  bool dense; ///< stop the solver at the next event and interpolate the records before it
+  bool replicate; ///< <code>sweep</code> runs replicates with new random effects
+  unsigned int NN; ///< number of rows in the output matrix
+  unsigned int neq; ///< number of compartments
+  unsigned int neta; ///< number of ETAs
+  unsigned int neps; ///< number of EPSs
+  arma::mat eta; ///< pre-simulated ETA values; one row per subject and replicate
+  std::vector<double> init; ///< initial conditions
+  std::vector<double> tofd; ///< time of first dose for each subject
+  std::vector<unsigned int> firstrow; ///< first output row for each subject
+
+protected:
+
+  void output_row(const unsigned int crow, const double id,
+                  const double time, odeproblem* prob);
+
+  dataobject* dat; ///< the data set
+  dataobject* idat; ///< the idata set; may be <code>NULL</code>
+  double* Ans; ///< output matrix storage
+  unsigned int Ans_nrow; ///< number of rows in the output matrix
+  unsigned int Ans_ncol; ///< number of columns in the output matrix
+  std::vector<int> Capture; ///< captured positions to write to output
+  std::vector<int> Request; ///< compartments to write to output
+  unsigned int capture_start; ///< first output column for captures
+  unsigned int req_start; ///< first output column for compartments
+  unsigned int nsens; ///< number of parameters with sensitivities
+  unsigned int sens_start; ///< first output column for sensitivities
+  std::vector<recpool*> Pools; ///< record storage; one pool per thread
+  std::vector<recpool*> Copies; ///< copies of data set records; one pool per thread
+
+  void scenario(const size_t k, const size_t i, recstack& a,
+                const double* param, const int K, const int npar,
+                const unsigned int nrow, odeproblem* prob, recpool& pool,
+                recpool& copies, reclist& recs);
+
+private:
+  simrun(const simrun&);
+  simrun& operator=(const simrun&);
+};
+
+#endif
@@ -0,0 +1,128 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file simsession.h
+ *
+ */
+
+#ifndef SIMSESSION_H
+#define SIMSESSION_H
+
+#include <vector>
+#include <string>
+#include "RcppInclude.h"
+#include "odeproblem.h"
+#include "dataobject.h"
+#include "simrun.h"
+
+/**
+ * @brief A simulation problem that is set up once and run many times.
+ *
+ * Creating a <code>simsession</code> does all of the work that only
+ * depends on the model and the data: the data objects, the record stack
+ * (including observations from the time grid), the output layout with
+ * the carried items already filled in and one <code>odeproblem</code>
+ * object for each thread.  <code>run</code> then simulates the whole data
+ * set with a new set of parameters and ETAs; only per-subject state is
+ * reset between runs.  <code>sweep</code> simulates the data set for many
+ * sets of parameters in one call and <code>replicate</code> simulates it
+ * many times with new random effects.  <code>fork</code> simulates up to 
+ * a checkpoint once and then simulates many different futures from 
+ * there.  <code>DEVTRAN</code> is a session that is run once.
+ *
+ * Data set records are copied when the session is created and put back
+ * before each run, because simulating changes some of them (infusion
+ * rates that come from the model and doses with a lag time).
+ */
+class simsession {
+
+public:
+  simsession(const Rcpp::List& parin,
+             const Rcpp::NumericVector& inpar,
+             const Rcpp::CharacterVector& parnames,
+             const Rcpp::NumericVector& init,
+             Rcpp::CharacterVector& cmtnames,
+             const Rcpp::IntegerVector& capture,
+             const Rcpp::List& funs,
+             const Rcpp::NumericMatrix& data,
+             const Rcpp::NumericMatrix& idata,
+             Rcpp::NumericMatrix& OMEGA,
+             Rcpp::NumericMatrix& SIGMA,
+             Rcpp::Environment envir);
+  ~simsession();
+
+  Rcpp::List run(const Rcpp::NumericVector& param,
+                 const Rcpp::NumericMatrix& eta);
+  Rcpp::List sweep(const Rcpp::NumericMatrix& param,
+                   const Rcpp::NumericMatrix& eta);
+  Rcpp::List replicate(const Rcpp::NumericVector& param, const int nrep);
+  Rcpp::List fork(const Rcpp::NumericVector& param,
+                  const Rcpp::NumericMatrix& eta,
+                  const double at,
+                  const Rcpp::List& branches);
+
+  unsigned int nid() const {return Nid;}
+  unsigned int npar() const {return Npar;}
+  unsigned int neta() const {return Neta;}
+  unsigned int runs() const {return Runs;}
+
+private:
+  void setup(const Rcpp::List& parin,
+             const Rcpp::NumericVector& inpar,
+             const Rcpp::NumericVector& init,
+             const Rcpp::IntegerVector& capture,
+             const Rcpp::List& funs,
+             const Rcpp::NumericMatrix& data,
+             const Rcpp::NumericMatrix& idata,
+             Rcpp::NumericMatrix& OMEGA,
+             Rcpp::NumericMatrix& SIGMA);
+  void release();
+  void reset_records();
+  void random_effects(const Rcpp::NumericMatrix& eta, const int nrep = 1,
+                      const bool stream_eps = false);
+  Rcpp::NumericMatrix stacked(const unsigned int K);
+  Rcpp::List results(Rcpp::NumericMatrix& ans, const std::string& err);
+
+  Rcpp::Environment Envir; ///< model environment
+  dataobject Dat; ///< the data set
+  dataobject Idat; ///< the idata set
+  recpool Pool; ///< storage for the records in <code>A</code>
+  recstack A; ///< records for each subject
+  std::vector<rec_ptr> Recs; ///< data set records in <code>A</code>
+  std::vector<datarecord> Saved; ///< data set records as they were created
+  std::vector<odeproblem*> Probs; ///< one problem for each thread
+  simrun* Sim; ///< the simulation engine
+  Rcpp::NumericMatrix Ans; ///< output template with carried items
+  Rcpp::CharacterVector Tran_names; ///< carried record items, in order
+  Rcpp::CharacterVector Parnames; ///< names of model parameters
+  std::vector<double> Grid; ///< observation times added to every subject
+  int Grid_pos; ///< record position for observations from <code>Grid</code>
+  unsigned int Nid; ///< number of subjects
+  unsigned int Neq; ///< number of compartments
+  unsigned int Npar; ///< number of parameters
+  unsigned int Neta; ///< number of ETAs
+  unsigned int Neps; ///< number of EPSs
+  unsigned int Req_start; ///< first output column with simulated values
+  int Stream_seed; ///< seed for the random streams, if given
+  bool Streaming; ///< ETAs come from the random streams
+  int Digits; ///< significant digits in the output
+  double Tscale; ///< scale for output times
+  unsigned int Runs; ///< number of times the session was run
+};
+
+#endif
@@ -32,6 +32,8 @@ RESP   : Response compartment
 EV2    : Second extravascular compartment (mass)
   
 
+$SET solver = "rk45"
+
 $GLOBAL
 #define CP (CENT/VC)
 #define CT (PERIPH/VP)
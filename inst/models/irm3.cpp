@@ -30,6 +30,8 @@ PERIPH : Peripheral compartment (mass)
 RESP   : Response compartment  
 EV2    : Second extravascular compartment (mass)
   
+$SET solver = "rk45"
+
 $GLOBAL
 #define CP (CENT/VC)
 #define CT (PERIPH/VP)
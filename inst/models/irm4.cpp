@@ -6,6 +6,8 @@ VMAX = 0, KM=2, n=1
 
 $CMT EV1 CENT PERIPH RESP EV2
 
+$SET solver = "rk45"
+
 $GLOBAL
 #define CP (CENT/VC)
 #define CT (PERIPH/VP)
@@ -205,6 +205,45 @@ dxdt_Aar = Qlu*(Clung/Kplu*BP) - Qlu*Carterial;   // arterial blood
 dxdt_Are = Qre*(Carterial - Crest/Kpre*BP);       // rest of body
 dxdt_D   = - Absorption;                          // oral dosing
 
+[ JAC ]
+
+// {Rate constants for leaving each tissue - 1/hr}
+double kad = Qad*BP/(Kpad*Vad);
+double kbo = Qbo*BP/(Kpbo*Vbo);
+double kbr = Qbr*BP/(Kpbr*Vbr);
+double kgu = Qgu*BP/(Kpgu*Vgu);
+double khe = Qhe*BP/(Kphe*Vhe);
+double kki = Qki*BP/(Kpki*Vki);
+double kli = Qh*BP/(Kpli*Vli);
+double klu = Qlu*BP/(Kplu*Vlu);
+double kmu = Qmu*BP/(Kpmu*Vmu);
+double ksk = Qsk*BP/(Kpsk*Vsk);
+double ksp = Qsp*BP/(Kpsp*Vsp);
+double kte = Qte*BP/(Kpte*Vte);
+double kre = Qre*BP/(Kpre*Vre);
+
+JAC(Aad,Aad) = -kad;  JAC(Aad,Aar) = Qad/Var;
+JAC(Abo,Abo) = -kbo;  JAC(Abo,Aar) = Qbo/Var;
+JAC(Abr,Abr) = -kbr;  JAC(Abr,Aar) = Qbr/Var;
+JAC(Agu,Agu) = -kgu;  JAC(Agu,Aar) = Qgu/Var;  JAC(Agu,D) = Ka;
+JAC(Ahe,Ahe) = -khe;  JAC(Ahe,Aar) = Qhe/Var;
+JAC(Aki,Aki) = -kki - CLrenal*fup/Vki;  JAC(Aki,Aar) = Qki/Var;
+JAC(Ali,Ali) = -kli - fup*CLmet/Vli;  JAC(Ali,Aar) = Qha/Var;
+JAC(Ali,Agu) = kgu;  JAC(Ali,Asp) = ksp;
+JAC(Alu,Alu) = -klu;  JAC(Alu,Ave) = Qlu/Vve;
+JAC(Amu,Amu) = -kmu;  JAC(Amu,Aar) = Qmu/Var;
+JAC(Ask,Ask) = -ksk;  JAC(Ask,Aar) = Qsk/Var;
+JAC(Asp,Asp) = -ksp;  JAC(Asp,Aar) = Qsp/Var;
+JAC(Ate,Ate) = -kte;  JAC(Ate,Aar) = Qte/Var;
+JAC(Are,Are) = -kre;  JAC(Are,Aar) = Qre/Var;
+JAC(Ave,Ave) = -Qlu/Vve;
+JAC(Ave,Aad) = kad;  JAC(Ave,Abo) = kbo;  JAC(Ave,Abr) = kbr;
+JAC(Ave,Ahe) = khe;  JAC(Ave,Aki) = kki;  JAC(Ave,Ali) = kli;
+JAC(Ave,Amu) = kmu;  JAC(Ave,Ask) = ksk;  JAC(Ave,Ate) = kte;
+JAC(Ave,Are) = kre;
+JAC(Aar,Aar) = -Qlu/Var;  JAC(Aar,Alu) = klu;
+JAC(D,D) = -Ka;
+
 [ CAPTURE ] Cvenous = Ave/Vve
 
 [ TABLE ] 
@@ -29,6 +29,8 @@ EV1  : First extravascular compartment
 CENT : Central compartment
 EV2  : Second extravascular compartment
 
+$SET solver = "rk45"
+
 $GLOBAL
 #define CP (CENT/VC)
 #define CT (PERIPH/VP)
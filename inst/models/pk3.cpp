@@ -0,0 +1,22 @@
+$PARAM @annotated
+CL   :   1 : Clearance (volume/time)
+V2   :  20 : Central volume (volume)
+Q3   :   2 : First inter-compartmental clearance (volume/time)
+V3   :  10 : First peripheral volume (volume)
+Q4   :   2 : Second inter-compartmental clearance (volume/time)
+V4   : 100 : Second peripheral volume (volume)
+KA   :   1 : Absorption rate constant (1/time)
+
+$CMT @annotated
+EV      : Extravascular compartment (mass)
+CENT    : Central compartment (mass)
+PERIPH  : First peripheral compartment (mass)
+PERIPH2 : Second peripheral compartment (mass)
+
+$GLOBAL
+#define CP (CENT/V2)
+
+$PKMODEL ncmt = 3, depot = TRUE
+
+$CAPTURE @annotated
+CP : Plasma concentration (mass/volume)
@@ -27,6 +27,24 @@ dxdt_TISS = KPT*CP*VC - KTP*TISS;
 dxdt_REC = KSYN - KDEG*REC - KON*CP*REC + KOFF*RC;
 dxdt_RC = KON*CP*REC - (KINT+KOFF)*RC;
 
+$JAC
+JAC(EV1,EV1) = -KA1;
+JAC(EV2,EV2) = -KA2;
+JAC(CENT,EV1) = KA1;
+JAC(CENT,EV2) = KA2;
+JAC(CENT,CENT) = -(KEL+KPT) - KON*REC;
+JAC(CENT,TISS) = KTP;
+JAC(CENT,REC) = -KON*CENT;
+JAC(CENT,RC) = KOFF*VC;
+JAC(TISS,CENT) = KPT;
+JAC(TISS,TISS) = -KTP;
+JAC(REC,CENT) = -KON*REC/VC;
+JAC(REC,REC) = -KDEG - KON*CP;
+JAC(REC,RC) = KOFF;
+JAC(RC,CENT) = KON*REC/VC;
+JAC(RC,REC) = KON*CP;
+JAC(RC,RC) = -(KINT+KOFF);
+
 $TABLE
 double TOTAL = REC+RC;
 
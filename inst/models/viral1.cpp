@@ -6,7 +6,7 @@ AUC = 0, IC50=2, eta=0
 
 $INIT expos=0,T = 1126801, I = 1126801, V = 8148974
 
-$SET delta = 02.5
+$SET delta = 02.5, solver = "rk45"
 
 $GLOBAL
 #define eps (expos/(IC50+expos))
@@ -8,7 +8,7 @@ $INIT
 expos=0, T = 1126801, I = 1126801, V = 8148974
 VM = 87.8, IM = 12.1
 
-$SET delta=0.2
+$SET delta=0.2, solver = "rk45"
 
 $GLOBAL
 #define a (s + rho*T_0*(1-((T_0+N)/Tmax)) - d*T_0)
@@ -138,3 +138,66 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// SESSION_NEW
+SEXP SESSION_NEW(const Rcpp::List parin, const Rcpp::NumericVector& inpar, const Rcpp::CharacterVector& parnames, const Rcpp::NumericVector& init, Rcpp::CharacterVector& cmtnames, const Rcpp::IntegerVector& capture, const Rcpp::List& funs, const Rcpp::NumericMatrix& data, const Rcpp::NumericMatrix& idata, Rcpp::NumericMatrix& OMEGA, Rcpp::NumericMatrix& SIGMA, Rcpp::Environment envir);
+RcppExport SEXP _mrgsolve_SESSION_NEW(SEXP parinSEXP, SEXP inparSEXP, SEXP parnamesSEXP, SEXP initSEXP, SEXP cmtnamesSEXP, SEXP captureSEXP, SEXP funsSEXP, SEXP dataSEXP, SEXP idataSEXP, SEXP OMEGASEXP, SEXP SIGMASEXP, SEXP envirSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List >::type parin(parinSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type inpar(inparSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type parnames(parnamesSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type init(initSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector& >::type cmtnames(cmtnamesSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type capture(captureSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type funs(funsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type idata(idataSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix& >::type OMEGA(OMEGASEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix& >::type SIGMA(SIGMASEXP);
+    Rcpp::traits::input_parameter< Rcpp::Environment >::type envir(envirSEXP);
+    rcpp_result_gen = Rcpp::wrap(SESSION_NEW(parin, inpar, parnames, init, cmtnames, capture, funs, data, idata, OMEGA, SIGMA, envir));
+    return rcpp_result_gen;
+END_RCPP
+}
+// SESSION_RUN
+Rcpp::List SESSION_RUN(SEXP xp, const Rcpp::NumericVector& param, const Rcpp::NumericMatrix& eta);
+RcppExport SEXP _mrgsolve_SESSION_RUN(SEXP xpSEXP, SEXP paramSEXP, SEXP etaSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type xp(xpSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type eta(etaSEXP);
+    rcpp_result_gen = Rcpp::wrap(SESSION_RUN(xp, param, eta));
+    return rcpp_result_gen;
+END_RCPP
+}
+// SESSION_SWEEP
+Rcpp::List SESSION_SWEEP(SEXP xp, const Rcpp::NumericMatrix& param, const Rcpp::NumericMatrix& eta);
+RcppExport SEXP _mrgsolve_SESSION_SWEEP(SEXP xpSEXP, SEXP paramSEXP, SEXP etaSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type xp(xpSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type eta(etaSEXP);
+    rcpp_result_gen = Rcpp::wrap(SESSION_SWEEP(xp, param, eta));
+    return rcpp_result_gen;
+END_RCPP
+}
+// SESSION_FORK
+Rcpp::List SESSION_FORK(SEXP xp, const Rcpp::NumericVector& param, const Rcpp::NumericMatrix& eta, const double at, const Rcpp::List& branches);
+RcppExport SEXP _mrgsolve_SESSION_FORK(SEXP xpSEXP, SEXP paramSEXP, SEXP etaSEXP, SEXP atSEXP, SEXP branchesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type xp(xpSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type eta(etaSEXP);
+    Rcpp::traits::input_parameter< const double >::type at(atSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type branches(branchesSEXP);
+    rcpp_result_gen = Rcpp::wrap(SESSION_FORK(xp, param, eta, at, branches));
+    return rcpp_result_gen;
+END_RCPP
+}
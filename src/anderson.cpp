@@ -0,0 +1,132 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file anderson.cpp
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "anderson.h"
+
+anderson::anderson(const int n, const int m) : N(n), M(m) {
+  if(M < 1) M = 1;
+  Flast.assign(N, 0.0);
+  Glast.assign(N, 0.0);
+  dF.assign(N*M, 0.0);
+  dG.assign(N*M, 0.0);
+  reset();
+}
+
+void anderson::reset() {
+  Nhist = 0;
+  Next = 0;
+  Have_last = false;
+}
+
+/**
+ * Propose the next input.
+ *
+ * The coefficients solve the least squares problem
+ * <code>min || f - dF * gamma ||</code> through the normal equations,
+ * with a small ridge so that nearly collinear history doesn't blow up.
+ * The history is dropped if the system can't be solved.
+ *
+ * @param x on input, the current input; on output, the next input
+ * @param g the image of <code>x</code> under the map
+ * @param w weights for the residual; usually one over the error tolerance
+ * for each element
+ */
+void anderson::step(std::vector<double>& x, const std::vector<double>& g,
+                    const std::vector<double>& w) {
+
+  std::vector<double> f(N);
+  for(int i = 0; i < N; ++i) f[i] = w[i]*(g[i] - x[i]);
+
+  if(Have_last) {
+    double* df = &dF[Next*N];
+    double* dg = &dG[Next*N];
+    for(int i = 0; i < N; ++i) {
+      df[i] = f[i] - Flast[i];
+      dg[i] = g[i] - Glast[i];
+    }
+    Next = (Next + 1) % M;
+    if(Nhist < M) ++Nhist;
+  }
+
+  Flast = f;
+  Glast = g;
+  Have_last = true;
+
+  x = g;
+
+  if(Nhist == 0) return;
+
+  const int k = Nhist;
+  std::vector<double> A(k*k, 0.0);
+  std::vector<double> b(k, 0.0);
+  double trace = 0.0;
+  for(int r = 0; r < k; ++r) {
+    const double* fr = &dF[r*N];
+    for(int c = r; c < k; ++c) {
+      const double* fc = &dF[c*N];
+      double sum = 0.0;
+      for(int i = 0; i < N; ++i) sum += fr[i]*fc[i];
+      A[r*k+c] = sum;
+      A[c*k+r] = sum;
+    }
+    double sum = 0.0;
+    for(int i = 0; i < N; ++i) sum += fr[i]*f[i];
+    b[r] = sum;
+    trace += A[r*k+r];
+  }
+  if(trace <= 0.0) {
+    reset();
+    return;
+  }
+  for(int r = 0; r < k; ++r) A[r*k+r] += 1E-10*trace;
+
+  // Gaussian elimination with partial pivoting
+  for(int c = 0; c < k; ++c) {
+    int p = c;
+    for(int r = c+1; r < k; ++r) {
+      if(std::fabs(A[r*k+c]) > std::fabs(A[p*k+c])) p = r;
+    }
+    if(A[p*k+c] == 0.0) {
+      reset();
+      return;
+    }
+    if(p != c) {
+      for(int j = 0; j < k; ++j) std::swap(A[c*k+j], A[p*k+j]);
+      std::swap(b[c], b[p]);
+    }
+    for(int r = c+1; r < k; ++r) {
+      double m = A[r*k+c]/A[c*k+c];
+      for(int j = c; j < k; ++j) A[r*k+j] -= m*A[c*k+j];
+      b[r] -= m*b[c];
+    }
+  }
+  for(int c = k-1; c >= 0; --c) {
+    for(int j = c+1; j < k; ++j) b[c] -= A[c*k+j]*b[j];
+    b[c] /= A[c*k+c];
+  }
+
+  for(int r = 0; r < k; ++r) {
+    const double* dg = &dG[r*N];
+    for(int i = 0; i < N; ++i) x[i] -= b[r]*dg[i];
+  }
+}
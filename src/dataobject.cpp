@@ -206,7 +206,7 @@ void dataobject::reload_parameters(const Rcpp::NumericVector& PARAM,
   }
 }
 
-void dataobject:: get_records_pred(recstack& a, int NID, int neq,
+void dataobject:: get_records_pred(recstack& a, recpool& pool, int NID, int neq,
                                    unsigned int& obscount, unsigned int& evcount,
                                    bool obsonly, bool debug) {
   
@@ -228,7 +228,7 @@ void dataobject:: get_records_pred(recstack& a, int NID, int neq,
         );
       }
       lastime = Data(j,col[_COL_time_]);        
-      rec_ptr obs = boost::make_shared<datarecord>(
+      rec_ptr obs = pool.make(
         Data(j,col[_COL_time_]),
         Data(j,col[_COL_cmt_]),
         j,
@@ -269,12 +269,12 @@ void dataobject:: get_records_pred(recstack& a, int NID, int neq,
 }
 
 
-void dataobject::get_records(recstack& a, int NID, int neq,
+void dataobject::get_records(recstack& a, recpool& pool, int NID, int neq,
                              unsigned int& obscount, unsigned int& evcount,
                              bool obsonly, bool debug) {
   
   if(neq==0) {
-    get_records_pred(a, NID, neq, obscount, evcount, obsonly, debug);
+    get_records_pred(a, pool, NID, neq, obscount, evcount, obsonly, debug);
     return;  
   }
   
@@ -317,7 +317,7 @@ void dataobject::get_records(recstack& a, int NID, int neq,
           );
         }
         
-        rec_ptr obs = boost::make_shared<datarecord>(
+        rec_ptr obs = pool.make(
           Data(j,col[_COL_time_]),
           Data(j,col[_COL_cmt_]),
           j,
@@ -342,7 +342,7 @@ void dataobject::get_records(recstack& a, int NID, int neq,
       
       ++evcount;
       
-      rec_ptr ev = boost::make_shared<datarecord>(
+      rec_ptr ev = pool.make(
         Data(j,col[_COL_cmt_]),
         Data(j,col[_COL_evid_]),
         Data(j,col[_COL_amt_]),
@@ -398,8 +398,10 @@ void dataobject::get_ids(uidtype* ids) {
   }
 }
 
-unsigned int dataobject::get_idata_row(const double ID) {
-  return idmap[ID];
+unsigned int dataobject::get_idata_row(const double ID) const {
+  idat_map::const_iterator it = idmap.find(ID);
+  if(it == idmap.end()) return 0;
+  return it->second;
 }
 
 void dataobject::check_idcol(dataobject& idat) {
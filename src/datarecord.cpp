@@ -24,12 +24,14 @@
 #include "RcppInclude.h"
 #include "datarecord.h"
 #include "odeproblem.h"
-#include <boost/make_shared.hpp>
 #include <functional>
 #include <algorithm>
+#include <new>
+#include <deque>
+#include <cmath>
+#include <cfloat>
+#include "anderson.h"
 
-#define N_SS 1000
-#define CRIT_DIFF_SS 1E-12
 
 // Tgrid Observations that need to get output
 // And Ptime observations
@@ -47,6 +49,8 @@ datarecord::datarecord(double time_, int pos_, bool output_) {
   Ii = 0;
   Ss = 0;
   Addl = 0;
+  Addl_k = 0;
+  Addl_start = 0;
   Id = 1;
   Fromdata=false;
   Armed = false;
@@ -65,6 +69,8 @@ datarecord::datarecord(double time_, short int cmt_, int pos_, double id_) {
   Ii = 0;
   Ss = 0;
   Addl = 0;
+  Addl_k = 0;
+  Addl_start = 0;
   Output = true;
   Armed = false;
   Fromdata=true;
@@ -83,6 +89,8 @@ datarecord::datarecord(short int cmt_, int evid_, double amt_, double time_,
   Amt = amt_;
   Rate = rate_;
   Addl = 0;
+  Addl_k = 0;
+  Addl_start = 0;
   Ii = 0;
   Ss = 0;
   Output = false;
@@ -105,6 +113,8 @@ datarecord::datarecord(short int cmt_, int evid_, double amt_,
   Pos = 1;
   Id = 1;
   Addl = 0;
+  Addl_k = 0;
+  Addl_start = 0;
   Ii = 0;
   Ss = 0;
   Output = false;
@@ -112,9 +122,90 @@ datarecord::datarecord(short int cmt_, int evid_, double amt_,
   Fromdata = false;
 }
 
+recpool::recpool(size_t block_size) {
+  Block_size = block_size > 0 ? block_size : 1;
+  Used = Block_size;
+  Count = 0;
+}
+
+recpool::~recpool() {
+  for(size_t b = 0; b < Blocks.size(); ++b) {
+    ::operator delete(static_cast<void*>(Blocks[b]));
+  }
+}
+
+/**
+ * Drop all of the records in the pool.  The first block of storage is 
+ * kept for the next records; handles made before the call are no longer 
+ * valid.
+ */
+void recpool::clear() {
+  for(size_t b = 1; b < Blocks.size(); ++b) {
+    ::operator delete(static_cast<void*>(Blocks[b]));
+  }
+  if(Blocks.size() > 0) {
+    Blocks.resize(1);
+    Used = 0;
+  }
+  Free.clear();
+  Count = 0;
+}
+
+void* recpool::slot() {
+  ++Count;
+  if(!Free.empty()) {
+    datarecord* rec = Free.back();
+    Free.pop_back();
+    return static_cast<void*>(rec);
+  }
+  if(Used == Block_size) {
+    void* mem = ::operator new(Block_size * sizeof(datarecord));
+    Blocks.push_back(static_cast<datarecord*>(mem));
+    Used = 0;
+  }
+  return static_cast<void*>(Blocks.back() + Used++);
+}
+
+rec_ptr recpool::make(double time_, int pos_, bool output_) {
+  return new (slot()) datarecord(time_, pos_, output_);
+}
+
+rec_ptr recpool::make(double time_, short int cmt_, int pos_, double id_) {
+  return new (slot()) datarecord(time_, cmt_, pos_, id_);
+}
 
+rec_ptr recpool::make(short int cmt_, int evid_, double amt_, double time_, 
+                      double rate_, int pos_, double id_) {
+  return new (slot()) datarecord(cmt_, evid_, amt_, time_, rate_, pos_, id_);
+}
 
-datarecord::~datarecord() {}
+rec_ptr recpool::make(short int cmt_, int evid_, double amt_, double time_, 
+                      double rate_) {
+  return new (slot()) datarecord(cmt_, evid_, amt_, time_, rate_);
+}
+
+rec_ptr recpool::make(const datarecord& rec) {
+  return new (slot()) datarecord(rec);
+}
+
+bool recheap::later::operator()(const entry& a, const entry& b) const {
+  if(a.rec->time() != b.rec->time()) return a.rec->time() > b.rec->time();
+  if(a.rec->pos() != b.rec->pos()) return a.rec->pos() > b.rec->pos();
+  return a.seq > b.seq;
+}
+
+void recheap::push(rec_ptr rec) {
+  entry e;
+  e.rec = rec;
+  e.seq = Count++;
+  Heap.push_back(e);
+  std::push_heap(Heap.begin(), Heap.end(), later());
+}
+
+void recheap::pop() {
+  std::pop_heap(Heap.begin(), Heap.end(), later());
+  Heap.pop_back();
+}
 
 bool CompByTimePosRec(const rec_ptr& a, const rec_ptr& b) {
   bool res = a->time() < b->time(); 
@@ -188,6 +279,7 @@ void datarecord::implement(odeproblem* prob) {
     break;
   case 8: // replace
     prob->y(eq_n, Amt);
+    prob->sens_clear(eq_n);
     break;
   case 4:
     for(int i=0; i < prob->neq(); ++i) {
@@ -205,24 +297,195 @@ void datarecord::implement(odeproblem* prob) {
       return;
     }
   }
-  prob->lsoda_init();
+  // The solver is restarted on the next advance only if this changed 
+  // the amounts or the derivatives; see odeproblem::warm_check
 }
 
 /* 
  * Brings system to steady state if appropriate.
  */
 void datarecord::steady(odeproblem* prob, double Fn) {
-  if(Fn==0) throw Rcpp::exception("Cannot use ss flag when F(n) is zero.",false);
+  if(Fn==0) throw mrgsolve_error("Cannot use ss flag when F(n) is zero.");
   if(Rate == 0) this->steady_bolus(prob);
   if(Rate >  0) this->steady_infusion(prob);
 }
 
+/**
+ * Closed-form steady state for <code>$PKMODEL</code> models (advan 1 
+ * through 4).
+ * 
+ * Over one dosing interval the model is linear: the amounts at the end of 
+ * the interval are <code>A * y + c</code>, where <code>y</code> are the 
+ * amounts at the start of the interval, <code>A</code> is the 
+ * homogeneous solution over <code>ii</code> and <code>c</code> is the 
+ * response to one dose given to an empty system.  Both come from the 
+ * same <code>advan2</code> / <code>advan4</code> code that advances the 
+ * system, so the steady-state trough is the solution of 
+ * <code>(I - A) y = c</code>; this is the sum of the geometric series 
+ * that the iterative method approaches.
+ * 
+ * On success, the amounts are set to the trough just before the next 
+ * dose, which is where the iterative method stops.
+ * 
+ * @param prob the odeproblem object
+ * @param evon the dose (bolus or infusion start) to give every interval
+ * @param duration the infusion duration; zero for a bolus
+ * @return <code>false</code> if the closed form can't be used (ODE models, 
+ * infusions that run longer than <code>ii</code>, or a system with no 
+ * elimination); the state is not changed in that case
+ */
+bool datarecord::steady_analytic(odeproblem* prob, datarecord& evon, 
+                                 double duration) {
+  
+  if(prob->advan() == 13) return false;
+  
+  // Sensitivities are carried through the dosing intervals one at a time
+  if(prob->nsens() > 0) return false;
+  
+  const int neq = prob->neq();
+  
+  if((neq < 1) || (neq > 4)) return false;
+  
+  if(duration > Ii) return false;
+  
+  double y0[4], c[4], ys[4], A[4][4];
+  int i, k;
+  
+  for(i = 0; i < neq; ++i) y0[i] = prob->y(i);
+  
+  // Homogeneous solution over one interval, one column at a time
+  for(k = 0; k < neq; ++k) {
+    for(i = 0; i < neq; ++i) prob->y(i, i==k ? 1.0 : 0.0);
+    prob->advance(0.0, Ii);
+    for(i = 0; i < neq; ++i) A[i][k] = prob->y(i);
+  }
+  
+  // One dose into an empty system
+  for(i = 0; i < neq; ++i) prob->y(i, 0.0);
+  evon.time(0.0);
+  evon.implement(prob);
+  if(duration > 0) {
+    prob->advance(0.0, duration);
+    datarecord evoff(Cmt, 9, Amt, duration, Rate);
+    evoff.implement(prob);
+    prob->advance(duration, Ii);
+  } else {
+    prob->advance(0.0, Ii);
+  }
+  for(i = 0; i < neq; ++i) c[i] = prob->y(i);
+  
+  // Solve (I - A) ys = c; Gaussian elimination with partial pivoting
+  double M[4][4];
+  for(i = 0; i < neq; ++i) {
+    for(k = 0; k < neq; ++k) M[i][k] = (i==k ? 1.0 : 0.0) - A[i][k];
+    ys[i] = c[i];
+  }
+  bool ok = true;
+  for(k = 0; k < neq && ok; ++k) {
+    int p = k;
+    for(i = k+1; i < neq; ++i) {
+      if(std::fabs(M[i][k]) > std::fabs(M[p][k])) p = i;
+    }
+    if(std::fabs(M[p][k]) < 1E-12) {
+      ok = false;
+      break;
+    }
+    if(p != k) {
+      for(i = 0; i < neq; ++i) std::swap(M[k][i], M[p][i]);
+      std::swap(ys[k], ys[p]);
+    }
+    for(i = k+1; i < neq; ++i) {
+      double m = M[i][k]/M[k][k];
+      for(int j = k; j < neq; ++j) M[i][j] -= m*M[k][j];
+      ys[i] -= m*ys[k];
+    }
+  }
+  if(ok) {
+    for(k = neq-1; k >= 0; --k) {
+      for(i = k+1; i < neq; ++i) ys[k] -= M[k][i]*ys[i];
+      ys[k] /= M[k][k];
+      if(!R_FINITE(ys[k])) ok = false;
+    }
+  }
+  
+  for(i = 0; i < neq; ++i) prob->y(i, ok ? ys[i] : y0[i]);
+  
+  return ok;
+}
+
+/**
+ * Check for steady state after one dosing interval.
+ * 
+ * A compartment is at steady state when its amount changed by no more 
+ * than <code>atol + rtol * |amount|</code> over the interval.  
+ * 
+ * @param x amounts at the start of the interval
+ * @param g amounts at the end of the interval
+ * @param w weights for the acceleration step; updated
+ * @param rtol relative tolerance
+ * @param atol absolute tolerance
+ * @return true if all compartments are at steady state
+ */
+static bool ss_check(const dvec& x, const dvec& g, dvec& w,
+                     const double rtol, const double atol) {
+  bool ok = true;
+  for(size_t j = 0; j < x.size(); ++j) {
+    double tol = atol + rtol*std::fabs(g[j]);
+    w[j] = 1.0/tol;
+    if(std::fabs(g[j] - x[j]) > tol) ok = false;
+  }
+  return ok;
+}
+
+/**
+ * Pick the amounts for the start of the next dosing interval with 
+ * Anderson acceleration.  The plain fixed-point step is used wherever 
+ * the accelerated step isn't finite or would make an amount negative.  
+ * When the weighted residual grew over the last interval, the last 
+ * accelerated step didn't help (for example, a stiff system with a long 
+ * interval); the history is dropped and the plain step is taken.
+ * 
+ * @param acc the accelerator
+ * @param x on input, amounts at the start of the interval; on output, 
+ * amounts for the start of the next interval
+ * @param g amounts at the end of the interval
+ * @param w residual weights
+ * @param rlast weighted residual from the last interval; updated
+ * @param prob the odeproblem object; amounts are set to <code>x</code>
+ */
+static void ss_next(anderson& acc, dvec& x, const dvec& g, const dvec& w, 
+                    double& rlast, odeproblem* prob) {
+  // Sensitivities are carried along with the amounts; plain fixed-point 
+  // iteration keeps them consistent
+  if(prob->nsens() > 0) return;
+  double r = 0.0;
+  for(size_t j = 0; j < x.size(); ++j) {
+    const double e = w[j]*(g[j] - x[j]);
+    r += e*e;
+  }
+  const bool grew = r > rlast;
+  rlast = r;
+  if(grew) {
+    acc.reset();
+    x = g;
+  } else {
+    acc.step(x, g, w);
+    for(size_t j = 0; j < x.size(); ++j) {
+      if(!R_FINITE(x[j]) || ((g[j] >= 0.0) && (x[j] < 0.0))) {
+        x = g;
+        break;
+      }
+    }
+  }
+  for(size_t j = 0; j < x.size(); ++j) prob->y(j, x[j]);
+}
+
 void datarecord::steady_bolus(odeproblem* prob) {
   
   dvec state_incoming;
   
   if(Ss == 2) {
-    state_incoming.resize(prob->neq());
+    state_incoming.resize(prob->nsys());
     for(size_t i = 0; i < state_incoming.size(); i++) {
       state_incoming[i] = prob->y(i);
     }
@@ -235,43 +498,60 @@ void datarecord::steady_bolus(odeproblem* prob) {
   int i;
   int j;
   
-  std::vector<double> res(prob->neq(),  1E-9);
-  std::vector<double> last(prob->neq(), 1E-9);
-  
-  double this_sum = 0.0;
-  double last_sum = 1E-6;
-  double diff = 1E6;
-  
   prob->lsoda_init();
   
-  rec_ptr evon = NEWREC(Cmt, 1, Amt, Time, Rate);
-  
-  for(i=1; i < N_SS; ++i) {
-    
-    tfrom = double(i-1)*Ii;
-    tto = double(i)*Ii;
-    
-    evon->implement(prob);
-    prob->lsoda_init();
-    prob->advance(tfrom,tto);
-    
-    for(j=0; j < prob->neq(); ++j) {
-      res[j]  = pow(prob->y(j) - last[j], 2.0);
-      last[j] = prob->y(j);
-    } 
+  datarecord evon(Cmt, 1, Amt, Time, Rate);
+  
+  int iter = 0;
+  bool converged = true;
+  dvec key;
+  const bool cache = prob->ss_cache_key(key, this, 0.0);
+  
+  if(cache && prob->ss_cache_get(key, tfrom, tto, iter, converged)) {
+    prob->on(this->cmtn());
+    prob->ss_log(Time, Cmt, iter, converged, true);
+  } else if(this->steady_analytic(prob, evon, 0.0)) {
+    tfrom = 0.0;
+    tto = Ii;
+    if(cache) prob->ss_cache_put(key, tfrom, tto, iter, converged);
+    prob->ss_log(Time, Cmt, iter, converged, false);
+  } else {
     
-    this_sum = std::accumulate(res.begin(), res.end(), 0.0);
+    // With sensitivities, they have to reach steady state too
+    const int neq = prob->nsys();
+    const int ss_n = prob->ss_n();
+    dvec x(neq), g(neq), w(neq);
+    double rlast = DBL_MAX;
+    anderson acc(neq);
+    converged = false;
     
-    if(i > 10) {
-      diff = std::abs(this_sum - last_sum);
-      if((diff < CRIT_DIFF_SS)){
-        tfrom = double(i-1)*Ii;
-        tto  = double(i)*Ii;
+    for(i=1; i <= ss_n; ++i) {
+      
+      tfrom = double(i-1)*Ii;
+      tto = double(i)*Ii;
+      
+      for(j=0; j < neq; ++j) x[j] = prob->y(j);
+      
+      evon.implement(prob);
+      prob->lsoda_init();
+      prob->advance(tfrom,tto);
+      
+      for(j=0; j < neq; ++j) g[j] = prob->y(j);
+      
+      if(ss_check(x, g, w, prob->ss_rtol(), prob->ss_atol())) {
+        converged = true;
         break;
       }
+      
+      if(i < ss_n) ss_next(acc, x, g, w, rlast, prob);
+    }
+    iter = converged ? i : ss_n;
+    // The closed form is the only result for advan 1-4 that doesn't depend 
+    // on the amounts we started from
+    if(cache && prob->advan()==13) {
+      prob->ss_cache_put(key, tfrom, tto, iter, converged);
     }
-    tfrom = tto;
-    last_sum = this_sum;
+    prob->ss_log(Time, Cmt, iter, converged, false);
   }
   
   // If we need a lagtime, give one more dose
@@ -279,12 +559,12 @@ void datarecord::steady_bolus(odeproblem* prob) {
   double lagt = prob->alag(this->cmtn());
   if(lagt > 0) {
     if(lagt >= Ii) {
-      throw Rcpp::exception("ALAG(n) greater than ii on ss record.",false);
+      throw mrgsolve_error("ALAG(n) greater than ii on ss record.");
     }
     if(Ss==2) {
-      throw Rcpp::exception("Ss == 2 with lag time is not currently supported.",false);
+      throw mrgsolve_error("Ss == 2 with lag time is not currently supported.");
     }
-    evon->implement(prob); 
+    evon.implement(prob); 
     prob->lsoda_init();
     prob->advance(tfrom, (tto - lagt));
   }
@@ -303,7 +583,7 @@ void datarecord::steady_infusion(odeproblem *prob) {
   dvec state_incoming;
   
   if(Ss == 2) {
-    state_incoming.resize(prob->neq());
+    state_incoming.resize(prob->nsys());
     for(size_t i = 0; i < state_incoming.size(); i++) {
       state_incoming[i] = prob->y(i);
     }
@@ -317,67 +597,91 @@ void datarecord::steady_infusion(odeproblem *prob) {
   
   int i;
   int j;
-  std::vector<double> res(prob->neq(), 0.0);
-  std::vector<double> last(prob->neq(),1E-10);
   
-  reclist offs;
+  std::deque<datarecord> offs;
   
-  double this_sum = 0.0;
-  double last_sum = 1E-6;
-  
-  double diff = 1E6;
-  double nexti, toff;
+  double nexti = 0.0, toff;
   prob->rate_reset();
   
   // We only need one of these; it gets updated and re-used immediately
-  rec_ptr evon = NEWREC(Cmt, 1, Amt, Time, Rate);
-  
-  for(i=1; i < N_SS ; ++i) {
-    evon->time(tfrom);
-    evon->implement(prob);
-    prob->lsoda_init();
-    toff = tfrom + duration;
+  datarecord evon(Cmt, 1, Amt, Time, Rate);
+  
+  int iter = 0;
+  bool converged = true;
+  dvec key;
+  // Infusions that are still running at the next dose leave rates behind; 
+  // those results aren't cached
+  const bool cache = (duration <= Ii) && prob->ss_cache_key(key, this, duration);
+  
+  if(cache && prob->ss_cache_get(key, tfrom, nexti, iter, converged)) {
+    prob->on(this->cmtn());
+    prob->ss_log(Time, Cmt, iter, converged, true);
+  } else if(this->steady_analytic(prob, evon, duration)) {
+    tfrom = 0.0;
+    nexti = Ii;
+    if(cache) prob->ss_cache_put(key, tfrom, nexti, iter, converged);
+    prob->ss_log(Time, Cmt, iter, converged, false);
+  } else {
+    
+    // With sensitivities, they have to reach steady state too
+    const int neq = prob->nsys();
+    const int ss_n = prob->ss_n();
+    dvec x(neq), g(neq), w(neq);
+    double rlast = DBL_MAX;
+    anderson acc(neq);
+    converged = false;
     
-    // Create an event to turn the infusion off and push onto offs vector
-    // Keep on creating these
-    rec_ptr evoff = NEWREC(Cmt, 9, Amt, toff, Rate);
-    offs.push_back(evoff);
+    // Infusions that run past the end of an interval carry into the next 
+    // ones; the interval map only repeats once the first of these is done
+    const int nwarm = int(std::ceil(duration/Ii));
     
-    // The next time an infusion will start
-    nexti = double(i)*Ii;
-    // As long as there are infusions to turn off and the
-    // first one is before or at the next infusion start time
-    while((!offs.empty()) && (offs[0]->time()  <= nexti)) {
+    for(i=1; i <= ss_n; ++i) {
       
-      toff = offs[0]->time();
-      prob->advance(tfrom,toff);
-      offs[0]->implement(prob);
+      for(j=0; j < neq; ++j) x[j] = prob->y(j);
+      
+      evon.time(tfrom);
+      evon.implement(prob);
       prob->lsoda_init();
-      tfrom = toff;
-      offs.erase(offs.begin());
-    }
-    
-    prob->lsoda_init();
-    prob->advance(tfrom,nexti);
-    
-    tfrom = nexti;
-    
-    for(j=0; j < prob->neq(); ++j) {
-      res[j]  = pow((prob->y(j)  - last[j]), 2.0);
-      last[j] = prob->y(j);
-    }
-    
-    this_sum = std::accumulate(res.begin(), res.end(), 0.0);
-    
-    if(i>10) {
-      diff = std::abs(this_sum - last_sum);
-      if(diff < CRIT_DIFF_SS) {
-        tfrom = nexti;
-        nexti  = double(i+1)*Ii;
+      toff = tfrom + duration;
+      
+      // Create an event to turn the infusion off and push onto offs vector
+      // Keep on creating these
+      offs.push_back(datarecord(Cmt, 9, Amt, toff, Rate));
+      
+      // The next time an infusion will start
+      nexti = double(i)*Ii;
+      // As long as there are infusions to turn off and the
+      // first one is before or at the next infusion start time
+      while((!offs.empty()) && (offs.front().time()  <= nexti)) {
+        
+        toff = offs.front().time();
+        prob->advance(tfrom,toff);
+        offs.front().implement(prob);
+        prob->lsoda_init();
+        tfrom = toff;
+        offs.pop_front();
+      }
+      
+      prob->advance(tfrom,nexti);
+      
+      tfrom = nexti;
+      
+      for(j=0; j < neq; ++j) g[j] = prob->y(j);
+      
+      if(ss_check(x, g, w, prob->ss_rtol(), prob->ss_atol()) && 
+         (i > nwarm)) {
+        converged = true;
         break;
       }
+      
+      if((i > nwarm) && (i < ss_n)) ss_next(acc, x, g, w, rlast, prob);
     }
-    last_sum = this_sum;
+    iter = converged ? i : ss_n;
+    nexti = tfrom + Ii;
+    if(cache && prob->advan()==13) {
+      prob->ss_cache_put(key, tfrom, nexti, iter, converged);
+    }
+    prob->ss_log(Time, Cmt, iter, converged, false);
   }
   
   // If we need a lagtime, give one more dose
@@ -385,29 +689,20 @@ void datarecord::steady_infusion(odeproblem *prob) {
   double lagt = prob->alag(this->cmtn());
   if(lagt > 0) {
     if(lagt >= Ii) {
-      throw Rcpp::exception(
-          "ALAG(n) greater than ii on ss record.",
-          false
-      );
+      throw mrgsolve_error("ALAG(n) greater than ii on ss record.");
     }
     if((duration + lagt) >= Ii) {
-      throw Rcpp::exception(
-          "Infusion duration + ALAG(n) greater than ii on ss record.",
-          false
-      );
+      throw mrgsolve_error("Infusion duration + ALAG(n) greater than ii on ss record.");
     }
     if(Ss==2) {
-      throw Rcpp::exception(
-          "Ss == 2 with lag time is not currently supported.",
-          false
-      );
+      throw mrgsolve_error("Ss == 2 with lag time is not currently supported.");
     }
-    evon->time(tfrom);
-    evon->implement(prob);
+    evon.time(tfrom);
+    evon.implement(prob);
     toff  = tfrom + duration;
     prob->advance(tfrom,toff);
-    rec_ptr evoff = NEWREC(Cmt, 9, Amt, toff, Rate);
-    evoff->implement(prob);
+    datarecord evoff(Cmt, 9, Amt, toff, Rate);
+    evoff.implement(prob);
     prob->lsoda_init();
     prob->advance(toff, (nexti - lagt));
   }
@@ -424,18 +719,22 @@ void datarecord::steady_infusion(odeproblem *prob) {
 /** 
  * Schedule out doses.  If the dose was an infusion, schedule the 
  * off infusion event.  If the dose included additional doses, 
- * create those events and add them to the stack.  No doses
+ * create the first of those events and add it to the stack.  No doses
  * will be scheduled beyond the maximum time for that individual.
  * 
- * @param thisi the record stack for this individual
+ * @param thisi the queue of scheduled records for this individual
+ * @param pool the pool to make new records in
  * @param maxtime the last time already in the record for the individual
  * @param put_ev_first logical; if true, the position of the event is -600; 
  * otherwise, it is beyond the last record of the stack.  But records
  * are always sorted first by time, then by position.
+ * @param Fn the bioavailability fraction
+ * @param ndata the number of data set records for the individual; the 
+ * stack is these plus everything pushed onto <code>thisi</code>
  * 
  */
-void datarecord::schedule(std::vector<rec_ptr>& thisi, double maxtime, 
-                          bool addl_ev_first, double Fn) {
+void datarecord::schedule(recheap& thisi, recpool& pool, double maxtime, 
+                          bool addl_ev_first, double Fn, size_t ndata) {
   
   // Steady state intermittent infusion
   if(this->ss_int_infusion() & (Fn > 0)) {
@@ -453,13 +752,14 @@ void datarecord::schedule(std::vector<rec_ptr>& thisi, double maxtime,
     
     for(int k=0; k < ninf_ss; ++k) {
       double offtime = first_off + double(k)*double(Ii);
-      rec_ptr evoff = NEWREC(Cmt, 9, Amt, offtime, Rate, -300, Id);
-      thisi.push_back(evoff);
+      rec_ptr evoff = pool.make(Cmt, 9, Amt, offtime, Rate, -300, Id);
+      thisi.push(evoff);
     } 
     
   } // end if ss
   
-  // Additional doses
+  // Additional doses; only the first one is scheduled here and each one
+  // schedules the next when it comes off the queue (see schedule_next)
   if(Addl > 0) {
     
     unsigned int this_evid = Evid;
@@ -468,26 +768,48 @@ void datarecord::schedule(std::vector<rec_ptr>& thisi, double maxtime,
       this_evid = Rate > 0 ? 5 : 1;
     }
     
-    if(this->int_infusion()) {
-      thisi.reserve(thisi.size() + 2*Addl);  
-    } else {
-      thisi.reserve(thisi.size() + Addl); 
-    }
+    double ontime = Time + Ii;
     
-    double ontime = 0;
+    if(ontime > maxtime) return;
     
-    int nextpos = addl_ev_first ?  (this->pos() - 600) : (thisi.size() + 10);
+    int nextpos = addl_ev_first ?  (this->pos() - 600) : (ndata + thisi.count() + 10);
+    
+    rec_ptr evon = pool.make(Cmt, this_evid, Amt, ontime, Rate, nextpos, Id);
+    evon->Addl = Addl;
+    evon->Ii = Ii;
+    evon->Addl_k = 1;
+    evon->Addl_start = Time;
+    
+    thisi.push(evon);
     
-    for(unsigned int k=1; k<=Addl; ++k) {
-      
-      ontime = Time + Ii*double(k);
-      
-      if(ontime > maxtime) break;
-      
-      rec_ptr evon = NEWREC(Cmt, this_evid, Amt, ontime, Rate, nextpos, Id);
-      
-      thisi.push_back(evon);
-      
-    }
   } // end addl
-}  
+}
+
+/**
+ * Schedule the next dose in a sequence of additional doses.  Nothing 
+ * happens unless this record is one of the doses scheduled by 
+ * <code>datarecord::schedule</code> and there are more doses to give 
+ * at or before the maximum time.  The next dose has the same position 
+ * as this one and its time is computed from the time of the original 
+ * dosing record so that times match doses given in the data set.
+ * 
+ * @param thisi the queue of scheduled records for this individual
+ * @param pool the pool to make new records in
+ * @param maxtime the last time already in the record for the individual
+ */
+void datarecord::schedule_next(recheap& thisi, recpool& pool, double maxtime) {
+  
+  if(!this->addl_pending()) return;
+  
+  double ontime = Addl_start + Ii*double(Addl_k + 1);
+  
+  if(ontime > maxtime) return;
+  
+  rec_ptr evon = pool.make(Cmt, Evid, Amt, ontime, Rate, Pos, Id);
+  evon->Addl = Addl;
+  evon->Ii = Ii;
+  evon->Addl_k = Addl_k + 1;
+  evon->Addl_start = Addl_start;
+  
+  thisi.push(evon);
+}
@@ -0,0 +1,1251 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file dlsoda.cpp
+ *
+ * Translated from the 12 November 2003 version of DLSODA (Livermore
+ * Solver for Ordinary Differential Equations, with Automatic method
+ * switching for stiff and nonstiff problems) by Alan C. Hindmarsh and
+ * Linda R. Petzold, part of ODEPACK.
+ *
+ * The translation keeps the statement labels and the 1-based indexing of
+ * the Fortran code so that it can be checked against the original line by
+ * line; <code>YH(i,j)</code> refers to row <code>i</code>, column
+ * <code>j</code> of the Nordsieck history array.
+ *
+ */
+
+#include <cmath>
+#include <cfloat>
+#include <sstream>
+#include <algorithm>
+#include "dlsoda.h"
+#include "odepack_dlsoda.h"
+
+#define YH(i,j) yh[((j)-1)*nyh + (i) - 1]
+#define YH1(i) yh[(i)-1]
+#define WM(i,j) wm[((j)-1)*n + (i) - 1]
+#define A(i,j) a[((j)-1)*n + (i) - 1]
+
+namespace {
+const int mord[3] = {0, 12, 5};
+const int mxstp0 = 500;
+const int mxhnl0 = 10;
+const double sm1[13] = {0.0, 0.5, 0.575, 0.55, 0.45, 0.35, 0.25,
+                        0.20, 0.15, 0.10, 0.075, 0.050, 0.025};
+}
+
+dlsoda::dlsoda(int neq_) {
+  n = neq_;
+  nyh = neq_;
+  init = 0;
+  srur = 0.0;
+  yh.assign(13*std::max(neq_,1), 0.0);
+  ewt.assign(std::max(neq_,1), 0.0);
+  savf.assign(std::max(neq_,1), 0.0);
+  acor.assign(std::max(neq_,1), 0.0);
+  wm.assign(std::max(neq_*neq_,1), 0.0);
+  ipvt.assign(std::max(neq_,1), 0);
+}
+
+/**
+ * Save a message from the solver.
+ *
+ * @param msg the message
+ * @param ni number of integers to report (0, 1 or 2)
+ * @param i1 first integer
+ * @param i2 second integer
+ * @param nr number of doubles to report (0, 1 or 2)
+ * @param r1 first double
+ * @param r2 second double
+ */
+void dlsoda::xerrwd(const std::string& msg, int ni, int i1, int i2,
+                    int nr, double r1, double r2) {
+  std::ostringstream ss;
+  ss << msg;
+  if(ni == 1) ss << std::endl << "In above message, I1 = " << i1;
+  if(ni == 2) ss << std::endl << "In above message, I1 = " << i1 << ", I2 = " << i2;
+  if(nr == 1) ss << std::endl << "In above message, R1 = " << r1;
+  if(nr == 2) ss << std::endl << "In above message, R1 = " << r1 << ", R2 = " << r2;
+  messages.push_back(ss.str());
+}
+
+double dlsoda::mnorm(const double* v, const double* w) const {
+  double vm = 0.0;
+  for(int i = 0; i < n; ++i) {
+    vm = std::max(vm, fabs(v[i])*w[i]);
+  }
+  return vm;
+}
+
+double dlsoda::fnorm(const double* a, const double* w) const {
+  double an = 0.0;
+  for(int i = 0; i < n; ++i) {
+    double sum = 0.0;
+    for(int j = 0; j < n; ++j) {
+      sum = sum + fabs(a[j*n + i])/w[j];
+    }
+    an = std::max(an, sum*w[i]);
+  }
+  return an;
+}
+
+void dlsoda::ewset(const double& rtol, const double& atol) {
+  for(int i = 1; i <= n; ++i) {
+    ewt[i-1] = rtol*fabs(YH(i,1)) + atol;
+  }
+}
+
+/**
+ * Set method coefficients (DCFODE).
+ *
+ * @param meth_ 1 for Adams, 2 for BDF
+ */
+void dlsoda::cfode(const int meth_) {
+  int i, ib, nq_, nqm1, nqp1;
+  double agamq, fnq, fnqm1, pc[14], pint, ragq, rqfac, rq1fac, tsign, xpin;
+
+  if(meth_ == 2) goto L200;
+
+  elco[1][1] = 1.0;
+  elco[1][2] = 1.0;
+  tesco[1][1] = 0.0;
+  tesco[1][2] = 2.0;
+  tesco[2][1] = 1.0;
+  tesco[12][3] = 0.0;
+  pc[1] = 1.0;
+  rqfac = 1.0;
+  for(nq_ = 2; nq_ <= 12; ++nq_) {
+    rq1fac = rqfac;
+    rqfac = rqfac/nq_;
+    nqm1 = nq_ - 1;
+    fnqm1 = nqm1;
+    nqp1 = nq_ + 1;
+    pc[nq_] = 0.0;
+    for(ib = 1; ib <= nqm1; ++ib) {
+      i = nqp1 - ib;
+      pc[i] = pc[i-1] + fnqm1*pc[i];
+    }
+    pc[1] = fnqm1*pc[1];
+    pint = pc[1];
+    xpin = pc[1]/2.0;
+    tsign = 1.0;
+    for(i = 2; i <= nq_; ++i) {
+      tsign = -tsign;
+      pint = pint + tsign*pc[i]/i;
+      xpin = xpin + tsign*pc[i]/(i+1);
+    }
+    elco[nq_][1] = pint*rq1fac;
+    elco[nq_][2] = 1.0;
+    for(i = 2; i <= nq_; ++i) {
+      elco[nq_][i+1] = rq1fac*pc[i]/i;
+    }
+    agamq = rqfac*xpin;
+    ragq = 1.0/agamq;
+    tesco[nq_][2] = ragq;
+    if(nq_ < 12) tesco[nqp1][1] = ragq*rqfac/nqp1;
+    tesco[nqm1][3] = ragq;
+  }
+  return;
+
+L200:
+  pc[1] = 1.0;
+  rq1fac = 1.0;
+  for(nq_ = 1; nq_ <= 5; ++nq_) {
+    fnq = nq_;
+    nqp1 = nq_ + 1;
+    pc[nqp1] = 0.0;
+    for(ib = 1; ib <= nq_; ++ib) {
+      i = nq_ + 2 - ib;
+      pc[i] = pc[i-1] + fnq*pc[i];
+    }
+    pc[1] = fnq*pc[1];
+    for(i = 1; i <= nqp1; ++i) {
+      elco[nq_][i] = pc[i]/pc[2];
+    }
+    elco[nq_][2] = 1.0;
+    tesco[nq_][1] = rq1fac;
+    tesco[nq_][2] = nqp1/elco[nq_][1];
+    tesco[nq_][3] = (nq_+2)/elco[nq_][1];
+    rq1fac = rq1fac/fnq;
+  }
+}
+
+/**
+ * Interpolate the solution or its derivatives at t (DINTDY).
+ *
+ * @param t the time to interpolate at; must be in the last step
+ * @param k the order of the derivative
+ * @param dky result
+ * @return 0 on success; -1 for illegal k; -2 for illegal t
+ */
+int dlsoda::intdy(const double t, const int k, double* dky) {
+  int i, ic, j, jb, jb2, jj, jj1, jp1;
+  double c, r, s, tp;
+
+  if(k < 0 || k > nq) {
+    xerrwd("DINTDY-  K (=I1) illegal", 1, k, 0, 0, 0.0, 0.0);
+    return -1;
+  }
+  tp = tn - hu - 100.0*uround*copysign(fabs(tn) + fabs(hu), hu);
+  if((t-tp)*(t-tn) > 0.0) {
+    xerrwd("DINTDY-  T (=R1) illegal", 0, 0, 0, 1, t, 0.0);
+    xerrwd("      T not in interval TCUR - HU (= R1) to TCUR (=R2)",
+           0, 0, 0, 2, tp, tn);
+    return -2;
+  }
+  s = (t - tn)/h;
+  ic = 1;
+  if(k != 0) {
+    jj1 = l - k;
+    for(jj = jj1; jj <= nq; ++jj) ic = ic*jj;
+  }
+  c = ic;
+  for(i = 1; i <= n; ++i) dky[i-1] = c*YH(i,l);
+  if(k == nq) goto L55;
+  jb2 = nq - k;
+  for(jb = 1; jb <= jb2; ++jb) {
+    j = nq - jb;
+    jp1 = j + 1;
+    ic = 1;
+    if(k != 0) {
+      jj1 = jp1 - k;
+      for(jj = jj1; jj <= j; ++jj) ic = ic*jj;
+    }
+    c = ic;
+    for(i = 1; i <= n; ++i) dky[i-1] = c*YH(i,jp1) + s*dky[i-1];
+  }
+  if(k == 0) return 0;
+L55:
+  r = pow(h, -k);
+  for(i = 0; i < n; ++i) dky[i] = r*dky[i];
+  return 0;
+}
+
+/**
+ * LU factorization of the iteration matrix (LINPACK DGEFA).
+ *
+ * @return 0 if successful; otherwise the index of a zero pivot
+ */
+int dlsoda::gefa(double* a, int* ip) {
+  int info = 0;
+  int j, k, kp1, idx, i;
+  double t, dmax;
+  for(k = 1; k <= n-1; ++k) {
+    kp1 = k + 1;
+    // IDAMAX
+    idx = k;
+    dmax = fabs(A(k,k));
+    for(i = k + 1; i <= n; ++i) {
+      if(fabs(A(i,k)) > dmax) {
+        idx = i;
+        dmax = fabs(A(i,k));
+      }
+    }
+    ip[k-1] = idx;
+    if(A(idx,k) == 0.0) {
+      info = k;
+      continue;
+    }
+    if(idx != k) {
+      t = A(idx,k);
+      A(idx,k) = A(k,k);
+      A(k,k) = t;
+    }
+    t = -1.0/A(k,k);
+    for(i = k + 1; i <= n; ++i) A(i,k) = t*A(i,k);
+    for(j = kp1; j <= n; ++j) {
+      t = A(idx,j);
+      if(idx != k) {
+        A(idx,j) = A(k,j);
+        A(k,j) = t;
+      }
+      if(t != 0.0) {
+        for(i = k + 1; i <= n; ++i) A(i,j) = A(i,j) + t*A(i,k);
+      }
+    }
+  }
+  ip[n-1] = n;
+  if(A(n,n) == 0.0) info = n;
+  return info;
+}
+
+/**
+ * Solve with the LU factors from <code>gefa</code> (LINPACK DGESL).
+ */
+void dlsoda::gesl(const double* a, const int* ip, double* b) {
+  int k, kb, idx, i;
+  double t;
+  for(k = 1; k <= n-1; ++k) {
+    idx = ip[k-1];
+    t = b[idx-1];
+    if(idx != k) {
+      b[idx-1] = b[k-1];
+      b[k-1] = t;
+    }
+    if(t != 0.0) {
+      for(i = k + 1; i <= n; ++i) b[i-1] = b[i-1] + t*A(i,k);
+    }
+  }
+  for(kb = 1; kb <= n; ++kb) {
+    k = n + 1 - kb;
+    b[k-1] = b[k-1]/A(k,k);
+    t = -b[k-1];
+    if(t != 0.0) {
+      for(i = 1; i <= k-1; ++i) b[i-1] = b[i-1] + t*A(i,k);
+    }
+  }
+}
+
+/**
+ * Form and factor the iteration matrix P = I - h*el0*J (DPRJA).  With
+ * <code>miter = 1</code>, the Jacobian comes from <code>call_jac</code>;
+ * otherwise, it is generated by finite differences and <code>acor</code> 
+ * is used as scratch space for the perturbed derivatives.
+ */
+void dlsoda::prja(odepack_dlsoda* prob, double* y) {
+  int i, j, j1, ier;
+  double fac, hl0, r, r0, yj;
+
+  nje = nje + 1;
+  ierpj = 0;
+  jcur = 1;
+  hl0 = h*el0;
+
+  if(miter == 1) {
+    for(i = 0; i < n*n; ++i) wm[i] = 0.0;
+    prob->call_jac(&n, &tn, y, &wm[0]);
+    for(i = 0; i < n*n; ++i) wm[i] = wm[i]*(-hl0);
+    goto L240;
+  }
+
+  fac = mnorm(&savf[0], &ewt[0]);
+  r0 = 1000.0*fabs(h)*uround*n*fac;
+  if(r0 == 0.0) r0 = 1.0;
+  j1 = 0;
+  for(j = 1; j <= n; ++j) {
+    yj = y[j-1];
+    r = std::max(srur*fabs(yj), r0/ewt[j-1]);
+    y[j-1] = y[j-1] + r;
+    fac = -hl0/r;
+    prob->call_derivs(&n, &tn, y, &acor[0]);
+    for(i = 0; i < n; ++i) {
+      wm[i+j1] = (acor[i] - savf[i])*fac;
+    }
+    y[j-1] = yj;
+    j1 = j1 + n;
+  }
+  nfe = nfe + n;
+
+L240:
+  pdnorm = fnorm(&wm[0], &ewt[0])/fabs(hl0);
+  for(i = 1; i <= n; ++i) WM(i,i) = WM(i,i) + 1.0;
+  ier = gefa(&wm[0], &ipvt[0]);
+  if(ier != 0) ierpj = 1;
+}
+
+void dlsoda::solsy(double* x) {
+  iersl = 0;
+  gesl(&wm[0], &ipvt[0], x);
+}
+
+/**
+ * Take one step (DSTODA).
+ */
+void dlsoda::stoda(odepack_dlsoda* prob, double* y, const int /*jt*/) {
+  int i, i1, iredo = 0, iret = 0, j, jb, m = 0, ncf, newq = 0;
+  int lm1, lm1p1, lm2, lm2p1, nqm1, nqm2 = 0;
+  double dcon, ddn, del = 0.0, delp, dsm = 0.0, dup, exdn, exsm, exup;
+  double r, rh = 0.0, rhdn, rhsm, rhup = 0.0, told;
+  double alpha, dm1, dm2, exm1, exm2, pdh = 0.0, pnorm = 0.0, rate = 0.0;
+  double rh1, rh1it, rh2, rm;
+
+  kflag = 0;
+  told = tn;
+  ncf = 0;
+  ierpj = 0;
+  iersl = 0;
+  jcur = 0;
+  icf = 0;
+  delp = 0.0;
+  if(jstart > 0) goto L200;
+  if(jstart == -1) goto L100;
+  if(jstart == -2) goto L160;
+
+  lmax = maxord + 1;
+  nq = 1;
+  l = 2;
+  ialth = 2;
+  rmax = 10000.0;
+  rc = 0.0;
+  el0 = 1.0;
+  crate = 0.7;
+  hold = h;
+  nslp = 0;
+  ipup = miter;
+  iret = 3;
+  icount = 20;
+  irflag = 0;
+  pdest = 0.0;
+  pdlast = 0.0;
+  ratio = 5.0;
+  cfode(2);
+  for(i = 1; i <= 5; ++i) cm2[i] = tesco[i][2]*elco[i][i+1];
+  cfode(1);
+  for(i = 1; i <= 12; ++i) cm1[i] = tesco[i][2]*elco[i][i+1];
+  goto L150;
+
+L100:
+  ipup = miter;
+  lmax = maxord + 1;
+  if(ialth == 1) ialth = 2;
+  if(meth == mused) goto L160;
+  cfode(meth);
+  ialth = l;
+  iret = 1;
+
+L150:
+  for(i = 1; i <= l; ++i) el[i] = elco[nq][i];
+  nqnyh = nq*nyh;
+  rc = rc*el[1]/el0;
+  el0 = el[1];
+  conit = 0.5/(nq+2);
+  if(iret == 1) goto L160;
+  if(iret == 2) goto L170;
+  goto L200;
+
+L160:
+  if(h == hold) goto L200;
+  rh = h/hold;
+  h = hold;
+  iredo = 3;
+  goto L175;
+
+L170:
+  rh = std::max(rh, hmin/fabs(h));
+
+L175:
+  rh = std::min(rh, rmax);
+  rh = rh/std::max(1.0, fabs(h)*hmxi*rh);
+  if(meth == 2) goto L178;
+  irflag = 0;
+  pdh = std::max(fabs(h)*pdlast, 0.000001);
+  if(rh*pdh*1.00001 < sm1[nq]) goto L178;
+  rh = sm1[nq]/pdh;
+  irflag = 1;
+
+L178:
+  r = 1.0;
+  for(j = 2; j <= l; ++j) {
+    r = r*rh;
+    for(i = 1; i <= n; ++i) YH(i,j) = YH(i,j)*r;
+  }
+  h = h*rh;
+  rc = rc*rh;
+  ialth = l;
+  if(iredo == 0) goto L690;
+
+L200:
+  if(fabs(rc-1.0) > ccmax) ipup = miter;
+  if(nst >= nslp+msbp) ipup = miter;
+  tn = tn + h;
+  i1 = nqnyh + 1;
+  for(jb = 1; jb <= nq; ++jb) {
+    i1 = i1 - nyh;
+    for(i = i1; i <= nqnyh; ++i) YH1(i) = YH1(i) + YH1(i+nyh);
+  }
+  pnorm = mnorm(&yh[0], &ewt[0]);
+
+L220:
+  m = 0;
+  rate = 0.0;
+  del = 0.0;
+  for(i = 1; i <= n; ++i) y[i-1] = YH(i,1);
+  prob->call_derivs(&n, &tn, y, &savf[0]);
+  nfe = nfe + 1;
+  if(ipup <= 0) goto L250;
+  prja(prob, y);
+  ipup = 0;
+  rc = 1.0;
+  nslp = nst;
+  crate = 0.7;
+  if(ierpj != 0) goto L430;
+
+L250:
+  for(i = 0; i < n; ++i) acor[i] = 0.0;
+
+L270:
+  if(miter != 0) goto L350;
+  for(i = 1; i <= n; ++i) {
+    savf[i-1] = h*savf[i-1] - YH(i,2);
+    y[i-1] = savf[i-1] - acor[i-1];
+  }
+  del = mnorm(y, &ewt[0]);
+  for(i = 1; i <= n; ++i) {
+    y[i-1] = YH(i,1) + el[1]*savf[i-1];
+    acor[i-1] = savf[i-1];
+  }
+  goto L400;
+
+L350:
+  for(i = 1; i <= n; ++i) y[i-1] = h*savf[i-1] - (YH(i,2) + acor[i-1]);
+  solsy(y);
+  if(iersl < 0) goto L430;
+  if(iersl > 0) goto L410;
+  del = mnorm(y, &ewt[0]);
+  for(i = 1; i <= n; ++i) {
+    acor[i-1] = acor[i-1] + y[i-1];
+    y[i-1] = YH(i,1) + el[1]*acor[i-1];
+  }
+
+L400:
+  if(del <= 100.0*pnorm*uround) goto L450;
+  if(m == 0 && meth == 1) goto L405;
+  if(m == 0) goto L402;
+  rm = 1024.0;
+  if(del <= 1024.0*delp) rm = del/delp;
+  rate = std::max(rate, rm);
+  crate = std::max(0.2*crate, rm);
+
+L402:
+  dcon = del*std::min(1.0, 1.5*crate)/(tesco[nq][2]*conit);
+  if(dcon > 1.0) goto L405;
+  pdest = std::max(pdest, rate/fabs(h*el[1]));
+  if(pdest != 0.0) pdlast = pdest;
+  goto L450;
+
+L405:
+  m = m + 1;
+  if(m == maxcor) goto L410;
+  if(m >= 2 && del > 2.0*delp) goto L410;
+  delp = del;
+  prob->call_derivs(&n, &tn, y, &savf[0]);
+  nfe = nfe + 1;
+  goto L270;
+
+L410:
+  if(miter == 0 || jcur == 1) goto L430;
+  icf = 1;
+  ipup = miter;
+  goto L220;
+
+L430:
+  icf = 2;
+  ncf = ncf + 1;
+  rmax = 2.0;
+  tn = told;
+  i1 = nqnyh + 1;
+  for(jb = 1; jb <= nq; ++jb) {
+    i1 = i1 - nyh;
+    for(i = i1; i <= nqnyh; ++i) YH1(i) = YH1(i) - YH1(i+nyh);
+  }
+  if(ierpj < 0 || iersl < 0) goto L680;
+  if(fabs(h) <= hmin*1.00001) goto L670;
+  if(ncf == mxncf) goto L670;
+  rh = 0.25;
+  ipup = miter;
+  iredo = 1;
+  goto L170;
+
+L450:
+  jcur = 0;
+  if(m == 0) dsm = del/tesco[nq][2];
+  if(m > 0) dsm = mnorm(&acor[0], &ewt[0])/tesco[nq][2];
+  if(dsm > 1.0) goto L500;
+  kflag = 0;
+  iredo = 0;
+  nst = nst + 1;
+  hu = h;
+  nqu = nq;
+  mused = meth;
+  for(j = 1; j <= l; ++j) {
+    for(i = 1; i <= n; ++i) YH(i,j) = YH(i,j) + el[j]*acor[i-1];
+  }
+  icount = icount - 1;
+  if(icount >= 0) goto L488;
+  if(meth == 2) goto L480;
+  if(nq > 5) goto L488;
+  if(dsm > 100.0*pnorm*uround && pdest != 0.0) goto L470;
+  if(irflag == 0) goto L488;
+  rh2 = 2.0;
+  nqm2 = std::min(nq, mxords);
+  goto L478;
+
+L470:
+  exsm = 1.0/l;
+  rh1 = 1.0/(1.2*pow(dsm,exsm) + 0.0000012);
+  rh1it = 2.0*rh1;
+  pdh = pdlast*fabs(h);
+  if(pdh*rh1 > 0.00001) rh1it = sm1[nq]/pdh;
+  rh1 = std::min(rh1, rh1it);
+  if(nq <= mxords) goto L474;
+  nqm2 = mxords;
+  lm2 = mxords + 1;
+  exm2 = 1.0/lm2;
+  lm2p1 = lm2 + 1;
+  dm2 = mnorm(&YH(1,lm2p1), &ewt[0])/cm2[mxords];
+  rh2 = 1.0/(1.2*pow(dm2,exm2) + 0.0000012);
+  goto L476;
+
+L474:
+  dm2 = dsm*(cm1[nq]/cm2[nq]);
+  rh2 = 1.0/(1.2*pow(dm2,exsm) + 0.0000012);
+  nqm2 = nq;
+
+L476:
+  if(rh2 < ratio*rh1) goto L488;
+
+L478:
+  rh = rh2;
+  icount = 20;
+  meth = 2;
+  miter = jtyp;
+  pdlast = 0.0;
+  nq = nqm2;
+  l = nq + 1;
+  goto L170;
+
+L480:
+  exsm = 1.0/l;
+  if(mxordn >= nq) goto L484;
+  nqm1 = mxordn;
+  lm1 = mxordn + 1;
+  exm1 = 1.0/lm1;
+  lm1p1 = lm1 + 1;
+  dm1 = mnorm(&YH(1,lm1p1), &ewt[0])/cm1[mxordn];
+  rh1 = 1.0/(1.2*pow(dm1,exm1) + 0.0000012);
+  goto L486;
+
+L484:
+  dm1 = dsm*(cm2[nq]/cm1[nq]);
+  rh1 = 1.0/(1.2*pow(dm1,exsm) + 0.0000012);
+  nqm1 = nq;
+  exm1 = exsm;
+
+L486:
+  rh1it = 2.0*rh1;
+  pdh = pdnorm*fabs(h);
+  if(pdh*rh1 > 0.00001) rh1it = sm1[nqm1]/pdh;
+  rh1 = std::min(rh1, rh1it);
+  rh2 = 1.0/(1.2*pow(dsm,exsm) + 0.0000012);
+  if(rh1*ratio < 5.0*rh2) goto L488;
+  alpha = std::max(0.001, rh1);
+  dm1 = pow(alpha,exm1)*dm1;
+  if(dm1 <= 1000.0*uround*pnorm) goto L488;
+  rh = rh1;
+  icount = 20;
+  meth = 1;
+  miter = 0;
+  pdlast = 0.0;
+  nq = nqm1;
+  l = nq + 1;
+  goto L170;
+
+L488:
+  ialth = ialth - 1;
+  if(ialth == 0) goto L520;
+  if(ialth > 1) goto L700;
+  if(l == lmax) goto L700;
+  for(i = 1; i <= n; ++i) YH(i,lmax) = acor[i-1];
+  goto L700;
+
+L500:
+  kflag = kflag - 1;
+  tn = told;
+  i1 = nqnyh + 1;
+  for(jb = 1; jb <= nq; ++jb) {
+    i1 = i1 - nyh;
+    for(i = i1; i <= nqnyh; ++i) YH1(i) = YH1(i) - YH1(i+nyh);
+  }
+  rmax = 2.0;
+  if(fabs(h) <= hmin*1.00001) goto L660;
+  if(kflag <= -3) goto L640;
+  iredo = 2;
+  rhup = 0.0;
+  goto L540;
+
+L520:
+  rhup = 0.0;
+  if(l == lmax) goto L540;
+  for(i = 1; i <= n; ++i) savf[i-1] = acor[i-1] - YH(i,lmax);
+  dup = mnorm(&savf[0], &ewt[0])/tesco[nq][3];
+  exup = 1.0/(l+1);
+  rhup = 1.0/(1.4*pow(dup,exup) + 0.0000014);
+
+L540:
+  exsm = 1.0/l;
+  rhsm = 1.0/(1.2*pow(dsm,exsm) + 0.0000012);
+  rhdn = 0.0;
+  if(nq == 1) goto L550;
+  ddn = mnorm(&YH(1,l), &ewt[0])/tesco[nq][1];
+  exdn = 1.0/nq;
+  rhdn = 1.0/(1.3*pow(ddn,exdn) + 0.0000013);
+
+L550:
+  if(meth == 2) goto L560;
+  pdh = std::max(fabs(h)*pdlast, 0.000001);
+  if(l < lmax) rhup = std::min(rhup, sm1[l]/pdh);
+  rhsm = std::min(rhsm, sm1[nq]/pdh);
+  if(nq > 1) rhdn = std::min(rhdn, sm1[nq-1]/pdh);
+  pdest = 0.0;
+
+L560:
+  if(rhsm >= rhup) goto L570;
+  if(rhup > rhdn) goto L590;
+  goto L580;
+
+L570:
+  if(rhsm < rhdn) goto L580;
+  newq = nq;
+  rh = rhsm;
+  goto L620;
+
+L580:
+  newq = nq - 1;
+  rh = rhdn;
+  if(kflag < 0 && rh > 1.0) rh = 1.0;
+  goto L620;
+
+L590:
+  newq = l;
+  rh = rhup;
+  if(rh < 1.1) goto L610;
+  r = el[l]/l;
+  for(i = 1; i <= n; ++i) YH(i,newq+1) = acor[i-1]*r;
+  goto L630;
+
+L610:
+  ialth = 3;
+  goto L700;
+
+L620:
+  if(meth == 2) goto L622;
+  if(rh*pdh*1.00001 >= sm1[newq]) goto L625;
+
+L622:
+  if(kflag == 0 && rh < 1.1) goto L610;
+
+L625:
+  if(kflag <= -2) rh = std::min(rh, 0.2);
+  if(newq == nq) goto L170;
+
+L630:
+  nq = newq;
+  l = nq + 1;
+  iret = 2;
+  goto L150;
+
+L640:
+  if(kflag == -10) goto L660;
+  rh = 0.1;
+  rh = std::max(hmin/fabs(h), rh);
+  h = h*rh;
+  for(i = 1; i <= n; ++i) y[i-1] = YH(i,1);
+  prob->call_derivs(&n, &tn, y, &savf[0]);
+  nfe = nfe + 1;
+  for(i = 1; i <= n; ++i) YH(i,2) = h*savf[i-1];
+  ipup = miter;
+  ialth = 5;
+  if(nq == 1) goto L200;
+  nq = 1;
+  l = 2;
+  iret = 3;
+  goto L150;
+
+L660:
+  kflag = -1;
+  goto L720;
+
+L670:
+  kflag = -2;
+  goto L720;
+
+L680:
+  kflag = -3;
+  goto L720;
+
+L690:
+  rmax = 10.0;
+
+L700:
+  r = 1.0/tesco[nqu][2];
+  for(i = 0; i < n; ++i) acor[i] = acor[i]*r;
+
+L720:
+  hold = h;
+  jstart = 1;
+}
+
+/**
+ * Integrate from t to tout (DLSODA).
+ *
+ * Arguments follow the Fortran routine, with scalar tolerances
+ * (<code>ITOL = 1</code>).  Optional inputs and outputs are read from and
+ * written to the same positions in <code>rwork</code> and
+ * <code>iwork</code> (C++ indexing) as before.
+ *
+ * @param prob the object that calculates the derivatives
+ * @param y the state vector
+ * @param t the current time; updated on return
+ * @param tout the output time
+ * @param rtol relative tolerance
+ * @param atol absolute tolerance
+ * @param itask task indicator (1 through 5)
+ * @param istate state indicator; 1 to start, 2 to continue
+ * @param iopt 1 if optional inputs are given in rwork and iwork
+ * @param rwork real optional inputs and outputs; at least 20 long
+ * @param iwork integer optional inputs and outputs; at least 20 long
+ * @param jt Jacobian type; 1 for a full Jacobian from 
+ * <code>call_jac</code> or 2 for one generated internally
+ */
+void dlsoda::run(odepack_dlsoda* prob, double* y, double& t,
+                 const double& tout, const double& rtol, const double& atol,
+                 const int itask, int& istate, const int iopt, double* rwork,
+                 int* iwork, const int jt) {
+
+  int i, iflag, imxer, kgo;
+  double atoli, ayi, big, ewti, h0 = 0.0, hmax, hmx, rh, rtoli;
+  double tcrit = 0.0, tdist, tnext, tol, tolsf = 0.0, tp, size, sum, w0;
+  bool ihit = false;
+
+  messages.clear();
+  aborted = false;
+
+  if(istate < 1 || istate > 3) goto L601;
+  if(itask < 1 || itask > 5) goto L602;
+  if(istate == 1) goto L10;
+  if(init == 0) goto L603;
+  if(istate == 2) goto L200;
+  goto L20;
+
+L10:
+  init = 0;
+  if(tout == t) return;
+
+L20:
+  if(n <= 0) goto L604;
+  if(jt < 1 || jt > 2) goto L608;
+  jtyp = jt;
+  if(iopt == 1) goto L40;
+  ixpr = 0;
+  mxstep = mxstp0;
+  mxhnil = mxhnl0;
+  hmxi = 0.0;
+  hmin = 0.0;
+  if(istate != 1) goto L60;
+  h0 = 0.0;
+  mxordn = mord[1];
+  mxords = mord[2];
+  goto L60;
+
+L40:
+  ixpr = iwork[4];
+  if(ixpr < 0 || ixpr > 1) goto L611;
+  mxstep = iwork[5];
+  if(mxstep < 0) goto L612;
+  if(mxstep == 0) mxstep = mxstp0;
+  mxhnil = iwork[6];
+  if(mxhnil < 0) goto L613;
+  if(mxhnil == 0) mxhnil = mxhnl0;
+  if(istate != 1) goto L50;
+  h0 = rwork[4];
+  mxordn = iwork[7];
+  if(mxordn < 0) goto L628;
+  if(mxordn == 0) mxordn = 100;
+  mxordn = std::min(mxordn, mord[1]);
+  mxords = iwork[8];
+  if(mxords < 0) goto L629;
+  if(mxords == 0) mxords = 100;
+  mxords = std::min(mxords, mord[2]);
+  if((tout - t)*h0 < 0.0) goto L614;
+
+L50:
+  hmax = rwork[5];
+  if(hmax < 0.0) goto L615;
+  hmxi = 0.0;
+  if(hmax > 0.0) hmxi = 1.0/hmax;
+  hmin = rwork[6];
+  if(hmin < 0.0) goto L616;
+
+L60:
+  if(istate == 1) meth = 1;
+  if(istate == 1) nyh = n;
+  rtoli = rtol;
+  atoli = atol;
+  i = 1;
+  if(rtoli < 0.0) goto L619;
+  if(atoli < 0.0) goto L620;
+  if(istate == 1) goto L100;
+  jstart = -1;
+  goto L200;
+
+L100:
+  uround = DBL_EPSILON;
+  tn = t;
+  tsw = t;
+  maxord = mxordn;
+  if(itask != 4 && itask != 5) goto L110;
+  tcrit = rwork[0];
+  if((tcrit - tout)*(tout - t) < 0.0) goto L625;
+  if(h0 != 0.0 && (t + h0 - tcrit)*h0 > 0.0) h0 = tcrit - t;
+
+L110:
+  jstart = 0;
+  nhnil = 0;
+  nst = 0;
+  nje = 0;
+  nslast = 0;
+  hu = 0.0;
+  nqu = 0;
+  mused = 0;
+  miter = 0;
+  ccmax = 0.3;
+  maxcor = 3;
+  msbp = 20;
+  mxncf = 10;
+  prob->call_derivs(&n, &t, y, &YH(1,2));
+  nfe = 1;
+  for(i = 1; i <= n; ++i) YH(i,1) = y[i-1];
+  nq = 1;
+  h = 1.0;
+  ewset(rtol, atol);
+  for(i = 1; i <= n; ++i) {
+    if(ewt[i-1] <= 0.0) goto L621;
+    ewt[i-1] = 1.0/ewt[i-1];
+  }
+  if(h0 != 0.0) goto L180;
+  tdist = fabs(tout - t);
+  w0 = std::max(fabs(t), fabs(tout));
+  if(tdist < 2.0*uround*w0) goto L622;
+  tol = rtol;
+  if(tol > 0.0) goto L160;
+  atoli = atol;
+  for(i = 1; i <= n; ++i) {
+    ayi = fabs(y[i-1]);
+    if(ayi != 0.0) tol = std::max(tol, atoli/ayi);
+  }
+
+L160:
+  tol = std::max(tol, 100.0*uround);
+  tol = std::min(tol, 0.001);
+  sum = mnorm(&YH(1,2), &ewt[0]);
+  sum = 1.0/(tol*w0*w0) + tol*(sum*sum);
+  h0 = 1.0/sqrt(sum);
+  h0 = std::min(h0, tdist);
+  h0 = copysign(h0, tout-t);
+
+L180:
+  rh = fabs(h0)*hmxi;
+  if(rh > 1.0) h0 = h0/rh;
+  h = h0;
+  for(i = 1; i <= n; ++i) YH(i,2) = h0*YH(i,2);
+  goto L270;
+
+L200:
+  nslast = nst;
+  switch(itask) {
+  case 1: goto L210;
+  case 2: goto L250;
+  case 3: goto L220;
+  case 4: goto L230;
+  default: goto L240;
+  }
+
+L210:
+  if((tn - tout)*h < 0.0) goto L250;
+  iflag = intdy(tout, 0, y);
+  if(iflag != 0) goto L627;
+  t = tout;
+  goto L420;
+
+L220:
+  tp = tn - hu*(1.0 + 100.0*uround);
+  if((tp - tout)*h > 0.0) goto L623;
+  if((tn - tout)*h < 0.0) goto L250;
+  t = tn;
+  goto L400;
+
+L230:
+  tcrit = rwork[0];
+  if((tn - tcrit)*h > 0.0) goto L624;
+  if((tcrit - tout)*h < 0.0) goto L625;
+  if((tn - tout)*h < 0.0) goto L245;
+  iflag = intdy(tout, 0, y);
+  if(iflag != 0) goto L627;
+  t = tout;
+  goto L420;
+
+L240:
+  tcrit = rwork[0];
+  if((tn - tcrit)*h > 0.0) goto L624;
+
+L245:
+  hmx = fabs(tn) + fabs(h);
+  ihit = fabs(tn - tcrit) <= 100.0*uround*hmx;
+  if(ihit) t = tcrit;
+  if(ihit) goto L400;
+  tnext = tn + h*(1.0 + 4.0*uround);
+  if((tnext - tcrit)*h <= 0.0) goto L250;
+  h = (tcrit - tn)*(1.0 - 4.0*uround);
+  if(istate == 2 && jstart >= 0) jstart = -2;
+
+L250:
+  if((nst-nslast) >= mxstep) goto L500;
+  ewset(rtol, atol);
+  for(i = 1; i <= n; ++i) {
+    if(ewt[i-1] <= 0.0) goto L510;
+    ewt[i-1] = 1.0/ewt[i-1];
+  }
+
+L270:
+  tolsf = uround*mnorm(&YH(1,1), &ewt[0]);
+  if(tolsf <= 1.0) goto L280;
+  tolsf = tolsf*2.0;
+  if(nst == 0) goto L626;
+  goto L520;
+
+L280:
+  if((tn + h) != tn) goto L290;
+  nhnil = nhnil + 1;
+  if(nhnil > mxhnil) goto L290;
+  xerrwd("DLSODA-  Warning..Internal T (=R1) and H (=R2) are", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("      such that in the machine, T + H = T on the next step  ", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("     (H = step size). Solver will continue anyway.", 0, 0, 0, 2, tn, h);
+  if(nhnil < mxhnil) goto L290;
+  xerrwd("DLSODA-  Above warning has been issued I1 times.  ", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("     It will not be issued again for this problem.", 1, mxhnil, 0, 0, 0.0, 0.0);
+
+L290:
+  stoda(prob, y, jt);
+  kgo = 1 - kflag;
+  if(kgo == 2) goto L530;
+  if(kgo == 3) goto L540;
+
+  init = 1;
+  if(meth == mused) goto L310;
+  tsw = tn;
+  maxord = mxordn;
+  if(meth == 2) maxord = mxords;
+  if(meth == 2) srur = sqrt(uround);
+  jstart = -1;
+  if(ixpr == 0) goto L310;
+  if(meth == 2) {
+    xerrwd("DLSODA- A switch to the BDF (stiff) method has occurred     ", 0, 0, 0, 0, 0.0, 0.0);
+  }
+  if(meth == 1) {
+    xerrwd("DLSODA- A switch to the Adams (nonstiff) method has occurred", 0, 0, 0, 0, 0.0, 0.0);
+  }
+  xerrwd("     at T = R1,  tentative step size H = R2,  step NST = I1 ", 1, nst, 0, 2, tn, h);
+
+L310:
+  switch(itask) {
+  case 1: goto L320;
+  case 2: goto L400;
+  case 3: goto L330;
+  case 4: goto L340;
+  default: goto L350;
+  }
+
+L320:
+  if((tn - tout)*h < 0.0) goto L250;
+  iflag = intdy(tout, 0, y);
+  t = tout;
+  goto L420;
+
+L330:
+  if((tn - tout)*h >= 0.0) goto L400;
+  goto L250;
+
+L340:
+  if((tn - tout)*h < 0.0) goto L345;
+  iflag = intdy(tout, 0, y);
+  t = tout;
+  goto L420;
+
+L345:
+  hmx = fabs(tn) + fabs(h);
+  ihit = fabs(tn - tcrit) <= 100.0*uround*hmx;
+  if(ihit) goto L400;
+  tnext = tn + h*(1.0 + 4.0*uround);
+  if((tnext - tcrit)*h <= 0.0) goto L250;
+  h = (tcrit - tn)*(1.0 - 4.0*uround);
+  if(jstart >= 0) jstart = -2;
+  goto L250;
+
+L350:
+  hmx = fabs(tn) + fabs(h);
+  ihit = fabs(tn - tcrit) <= 100.0*uround*hmx;
+
+L400:
+  for(i = 1; i <= n; ++i) y[i-1] = YH(i,1);
+  t = tn;
+  if(itask != 4 && itask != 5) goto L420;
+  if(ihit) t = tcrit;
+
+L420:
+  istate = 2;
+  rwork[10] = hu;
+  rwork[11] = h;
+  rwork[12] = tn;
+  rwork[14] = tsw;
+  iwork[10] = nst;
+  iwork[11] = nfe;
+  iwork[12] = nje;
+  iwork[13] = nqu;
+  iwork[14] = nq;
+  iwork[18] = mused;
+  iwork[19] = meth;
+  return;
+
+L500:
+  xerrwd("DLSODA-  At current T (=R1), MXSTEP (=I1) steps   ", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("      taken on this call before reaching TOUT     ", 1, mxstep, 0, 1, tn, 0.0);
+  istate = -1;
+  goto L580;
+
+L510:
+  ewti = ewt[i-1];
+  xerrwd("DLSODA-  At T (=R1), EWT(I1) has become R2 .le. 0.", 1, i, 0, 2, tn, ewti);
+  istate = -6;
+  goto L580;
+
+L520:
+  xerrwd("DLSODA-  At T (=R1), too much accuracy requested  ", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("      for precision of machine..  See TOLSF (=R2) ", 0, 0, 0, 2, tn, tolsf);
+  rwork[13] = tolsf;
+  istate = -2;
+  goto L580;
+
+L530:
+  xerrwd("DLSODA-  At T(=R1) and step size H(=R2), the error", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("      test failed repeatedly or with ABS(H) = HMIN", 0, 0, 0, 2, tn, h);
+  istate = -4;
+  goto L560;
+
+L540:
+  xerrwd("DLSODA-  At T (=R1) and step size H (=R2), the    ", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("      corrector convergence failed repeatedly     ", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("      or with ABS(H) = HMIN   ", 0, 0, 0, 2, tn, h);
+  istate = -5;
+
+L560:
+  big = 0.0;
+  imxer = 1;
+  for(i = 1; i <= n; ++i) {
+    size = fabs(acor[i-1]*ewt[i-1]);
+    if(big >= size) continue;
+    big = size;
+    imxer = i;
+  }
+  iwork[15] = imxer;
+
+L580:
+  for(i = 1; i <= n; ++i) y[i-1] = YH(i,1);
+  t = tn;
+  rwork[10] = hu;
+  rwork[11] = h;
+  rwork[12] = tn;
+  rwork[14] = tsw;
+  iwork[10] = nst;
+  iwork[11] = nfe;
+  iwork[12] = nje;
+  iwork[13] = nqu;
+  iwork[14] = nq;
+  iwork[18] = mused;
+  iwork[19] = meth;
+  return;
+
+L601:
+  xerrwd("DLSODA-  ISTATE (=I1) illegal.", 1, istate, 0, 0, 0.0, 0.0);
+  if(istate < 0) goto L800;
+  goto L700;
+L602:
+  xerrwd("DLSODA-  ITASK (=I1) illegal. ", 1, itask, 0, 0, 0.0, 0.0);
+  goto L700;
+L603:
+  xerrwd("DLSODA-  ISTATE .gt. 1 but DLSODA not initialized.", 0, 0, 0, 0, 0.0, 0.0);
+  goto L700;
+L604:
+  xerrwd("DLSODA-  NEQ (=I1) .lt. 1     ", 1, n, 0, 0, 0.0, 0.0);
+  goto L700;
+L608:
+  xerrwd("DLSODA-  JT (=I1) illegal.    ", 1, jt, 0, 0, 0.0, 0.0);
+  goto L700;
+L611:
+  xerrwd("DLSODA-  IXPR (=I1) illegal.  ", 1, ixpr, 0, 0, 0.0, 0.0);
+  goto L700;
+L612:
+  xerrwd("DLSODA-  MXSTEP (=I1) .lt. 0  ", 1, mxstep, 0, 0, 0.0, 0.0);
+  goto L700;
+L613:
+  xerrwd("DLSODA-  MXHNIL (=I1) .lt. 0  ", 1, mxhnil, 0, 0, 0.0, 0.0);
+  goto L700;
+L614:
+  xerrwd("DLSODA-  TOUT (=R1) behind T (=R2)      ", 0, 0, 0, 2, tout, t);
+  xerrwd("      Integration direction is given by H0 (=R1)  ", 0, 0, 0, 1, h0, 0.0);
+  goto L700;
+L615:
+  xerrwd("DLSODA-  HMAX (=R1) .lt. 0.0  ", 0, 0, 0, 1, hmax, 0.0);
+  goto L700;
+L616:
+  xerrwd("DLSODA-  HMIN (=R1) .lt. 0.0  ", 0, 0, 0, 1, hmin, 0.0);
+  goto L700;
+L619:
+  xerrwd("DLSODA-  RTOL(I1) is R1 .lt. 0.0        ", 1, i, 0, 1, rtoli, 0.0);
+  goto L700;
+L620:
+  xerrwd("DLSODA-  ATOL(I1) is R1 .lt. 0.0        ", 1, i, 0, 1, atoli, 0.0);
+  goto L700;
+L621:
+  ewti = ewt[i-1];
+  xerrwd("DLSODA-  EWT(I1) is R1 .le. 0.0         ", 1, i, 0, 1, ewti, 0.0);
+  goto L700;
+L622:
+  xerrwd("DLSODA-  TOUT(=R1) too close to T(=R2) to start integration.", 0, 0, 0, 2, tout, t);
+  goto L700;
+L623:
+  xerrwd("DLSODA-  ITASK = I1 and TOUT (=R1) behind TCUR - HU (= R2)  ", 1, itask, 0, 2, tout, tp);
+  goto L700;
+L624:
+  xerrwd("DLSODA-  ITASK = 4 or 5 and TCRIT (=R1) behind TCUR (=R2)   ", 0, 0, 0, 2, tcrit, tn);
+  goto L700;
+L625:
+  xerrwd("DLSODA-  ITASK = 4 or 5 and TCRIT (=R1) behind TOUT (=R2)   ", 0, 0, 0, 2, tcrit, tout);
+  goto L700;
+L626:
+  xerrwd("DLSODA-  At start of problem, too much accuracy   ", 0, 0, 0, 0, 0.0, 0.0);
+  xerrwd("      requested for precision of machine..  See TOLSF (=R1) ", 0, 0, 0, 1, tolsf, 0.0);
+  rwork[13] = tolsf;
+  goto L700;
+L627:
+  xerrwd("DLSODA-  Trouble in DINTDY.  ITASK = I1, TOUT = R1", 1, itask, 0, 1, tout, 0.0);
+  goto L700;
+L628:
+  xerrwd("DLSODA-  MXORDN (=I1) .lt. 0  ", 1, mxordn, 0, 0, 0.0, 0.0);
+  goto L700;
+L629:
+  xerrwd("DLSODA-  MXORDS (=I1) .lt. 0  ", 1, mxords, 0, 0, 0.0, 0.0);
+
+L700:
+  istate = -3;
+  return;
+
+L800:
+  xerrwd("DLSODA-  Run aborted.. apparent infinite loop.    ", 0, 0, 0, 0, 0.0, 0.0);
+  aborted = true;
+}
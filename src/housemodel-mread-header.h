@@ -20,11 +20,11 @@
 // GLOBAL VARS FROM BLOCKS & TYPEDEFS:
 typedef double capture;
 namespace {
-  double CLi;
-  double VCi;
-  double KAi;
-  double KOUTi;
-  double DV;
+  MRGSOLVE_THREAD_LOCAL double CLi;
+  MRGSOLVE_THREAD_LOCAL double VCi;
+  MRGSOLVE_THREAD_LOCAL double KAi;
+  MRGSOLVE_THREAD_LOCAL double KOUTi;
+  MRGSOLVE_THREAD_LOCAL double DV;
 }
 typedef double localdouble;
 typedef int localint;
@@ -40,6 +40,7 @@ typedef double localdouble;
 #define __ODEFUN___ _model_housemodel_ode__
 #define __TABLECODE___ _model_housemodel_table__
 #define __CONFIGFUN___ _model_housemodel_config__
+#define __VARSFUN___ _model_housemodel_vars__
 #define __REGISTERFUN___ R_init_housemodel
 #define _nEQ 3
 #define _nPAR 14
@@ -24,6 +24,15 @@ dxdt_CENT = KAi*GUT - (CLi/VCi)*CENT;
 dxdt_RESP = KIN*(1-INH) - KOUTi*RESP;
 __END_ode__
 
+// MAIN VARIABLES:
+__BEGIN_vars__
+_NVARS_(4)
+_MAINVAR_(0,CLi)
+_MAINVAR_(1,VCi)
+_MAINVAR_(2,KAi)
+_MAINVAR_(3,KOUTi)
+__END_vars__
+
 // TABLE CODE BLOCK:
 __BEGIN_table__
 DV = CP*exp(EXPO);
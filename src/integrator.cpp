@@ -0,0 +1,941 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file integrator.cpp
+ */
+
+#include <cmath>
+#include <cfloat>
+#include <sstream>
+#include <algorithm>
+#include "integrator.h"
+#include "odepack_dlsoda.h"
+
+/**
+ * LU factorization of the <code>n</code> by <code>n</code> column-major 
+ * matrix <code>a</code> in place, with partial pivoting.
+ *
+ * @return false if <code>a</code> is singular
+ */
+static bool lu_factor(double* a, int* piv, const int n) {
+  for(int k = 0; k < n; ++k) {
+    int p = k;
+    double big = std::fabs(a[k + k*n]);
+    for(int i = k+1; i < n; ++i) {
+      if(std::fabs(a[i + k*n]) > big) {
+        big = std::fabs(a[i + k*n]);
+        p = i;
+      }
+    }
+    piv[k] = p;
+    if(big == 0.0) return false;
+    if(p != k) {
+      for(int j = k; j < n; ++j) std::swap(a[k + j*n], a[p + j*n]);
+    }
+    const double d = a[k + k*n];
+    for(int i = k+1; i < n; ++i) {
+      a[i + k*n] /= d;
+    }
+    for(int j = k+1; j < n; ++j) {
+      const double w = a[k + j*n];
+      if(w == 0.0) continue;
+      for(int i = k+1; i < n; ++i) {
+        a[i + j*n] -= a[i + k*n]*w;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Solve <code>a x = b</code> with the factors from <code>lu_factor</code>;
+ * <code>b</code> is overwritten with <code>x</code>.
+ */
+static void lu_solve(const double* a, const int* piv, const int n, 
+                     double* b) {
+  for(int k = 0; k < n; ++k) {
+    if(piv[k] != k) std::swap(b[k], b[piv[k]]);
+    for(int i = k+1; i < n; ++i) {
+      b[i] -= a[i + k*n]*b[k];
+    }
+  }
+  for(int k = n-1; k >= 0; --k) {
+    b[k] /= a[k + k*n];
+    for(int i = 0; i < k; ++i) {
+      b[i] -= a[i + k*n]*b[k];
+    }
+  }
+}
+
+onestep::onestep(int neq_) {
+  N = neq_;
+  int n = std::max(neq_,1);
+  Tn = 0.0;
+  Told = 0.0;
+  H = 0.0;
+  Hu = 0.0;
+  Yn.assign(n, 0.0);
+  Fn.assign(n, 0.0);
+  Ynew.assign(n, 0.0);
+  Fnew.assign(n, 0.0);
+  Err.assign(n, 0.0);
+  Nst = 0;
+  Nfe = 0;
+  Nje = 0;
+  Started = false;
+  Rejected = false;
+}
+
+/**
+ * Advance the solution to <code>tout</code>.
+ *
+ * See <code>integrator</code> for the arguments.  The step size carries
+ * over from call to call when <code>istate = 2</code>; with
+ * <code>istate = 1</code> the solver starts over from <code>t</code> and
+ * <code>y</code>.  On an error, <code>istate</code> is negative,
+ * <code>t</code> and <code>y</code> hold the last point the solver reached
+ * and the reason is in <code>messages</code>.
+ */
+void onestep::run(odepack_dlsoda* prob, double* y, double& t,
+                  const double& tout, const double& rtol, const double& atol,
+                  const int itask, int& istate, const int iopt,
+                  double* rwork, int* iwork, const int jt) {
+
+  messages.clear();
+  aborted = false;
+
+  if(istate < 0) {
+    messages.push_back("Run aborted.. apparent infinite loop.");
+    aborted = true;
+    return;
+  }
+
+  if(istate < 1 || istate > 2 || itask < 1 || itask > 5 || itask == 3 ||
+     (istate == 2 && !Started)) {
+    std::stringstream ss;
+    ss << "illegal input: istate = " << istate << ", itask = " << itask;
+    messages.push_back(ss.str());
+    istate = -3;
+    return;
+  }
+
+  int mxstep = 500;
+  double hmax = 0.0;
+  if(iopt == 1) {
+    if(iwork[5] > 0) mxstep = iwork[5];
+    if(rwork[5] > 0.0) hmax = rwork[5];
+  }
+
+  const bool stop = itask == 4 || itask == 5;
+  const bool one = itask == 2 || itask == 5;
+  const double tcrit = rwork[0];
+  if(stop && tcrit < tout) {
+    messages.push_back("itask = 4 or 5 and tcrit is behind tout.");
+    istate = -3;
+    return;
+  }
+
+  if(istate == 1) {
+    Started = false;
+    Nst = 0;
+    Nfe = 0;
+    Nje = 0;
+    Tn = t;
+    Told = t;
+    Hu = 0.0;
+    for(int i = 0; i < N; ++i) Yn[i] = y[i];
+    prob->call_derivs(&N, &Tn, &Yn[0], &Fn[0]);
+    ++Nfe;
+    this->start(prob);
+    H = initial_step(prob, rtol, atol, hmax, std::fabs(tout - t));
+    Rejected = false;
+    Started = true;
+  }
+
+  if(tout < Told || (stop && tcrit < Tn)) {
+    std::stringstream ss;
+    ss << "tout (= " << tout << ") is behind the current step.";
+    messages.push_back(ss.str());
+    istate = -3;
+    return;
+  }
+
+  int nstep = 0;
+  while(one || Tn < tout) {
+    if(nstep >= mxstep) {
+      std::stringstream ss;
+      ss << "at t (= " << Tn << "), mxstep (= " << mxstep
+         << ") steps taken before reaching tout.";
+      messages.push_back(ss.str());
+      for(int i = 0; i < N; ++i) y[i] = Yn[i];
+      t = Tn;
+      istate = -1;
+      break;
+    }
+
+    double h = H;
+    if(hmax > 0.0 && h > hmax) h = hmax;
+
+    // Land exactly on tcrit; a sliver that is all rounding error is
+    // treated as already there
+    bool hit = false;
+    if(stop && Tn + h*(1.0 + 4.0*DBL_EPSILON) >= tcrit) {
+      h = tcrit - Tn;
+      hit = true;
+      if(h <= 100.0*DBL_EPSILON*std::fabs(tcrit)) {
+        Tn = tcrit;
+        break;
+      }
+    }
+
+    const double err = attempt(prob, h, rtol, atol, jt);
+    const double p = 1.0/static_cast<double>(order());
+
+    if(err <= 1.0) {
+      Told = Tn;
+      Tn = hit ? tcrit : Tn + h;
+      Hu = h;
+      this->accept();
+      ++Nst;
+      ++nstep;
+      double fac = err == 0.0 ? 5.0 : 0.9*std::pow(err, -p);
+      fac = std::min(5.0, std::max(0.2, fac));
+      if(Rejected) fac = std::min(fac, 1.0);
+      // A step cut short to land on tcrit says nothing about the step size
+      if(!hit || h >= H) H = h*fac;
+      Rejected = false;
+      if(one) break;
+    } else {
+      double fac = err <= DBL_MAX ? 0.9*std::pow(err, -p) : 0.2;
+      H = h*std::max(0.2, fac);
+      Rejected = true;
+      if(Tn + H == Tn) {
+        std::stringstream ss;
+        ss << "at t (= " << Tn << "), the step size (h = " << H
+           << ") is too small for the error test to pass.";
+        messages.push_back(ss.str());
+        for(int i = 0; i < N; ++i) y[i] = Yn[i];
+        t = Tn;
+        istate = -1;
+        Started = false;
+        break;
+      }
+    }
+  }
+
+  if(istate > 0) {
+    if(one || tout == Tn || Hu == 0.0) {
+      for(int i = 0; i < N; ++i) y[i] = Yn[i];
+    } else {
+      interpolate(tout, y);
+    }
+    t = one ? Tn : tout;
+    istate = 2;
+  }
+
+  rwork[10] = Hu;
+  rwork[11] = H;
+  rwork[12] = Tn;
+  iwork[10] = Nst;
+  iwork[11] = Nfe;
+  iwork[12] = Nje;
+}
+
+/**
+ * Pick the first step size (Hairer, Norsett and Wanner, II.4).
+ *
+ * Uses <code>Ynew</code> and <code>Fnew</code> as scratch.
+ */
+double onestep::initial_step(odepack_dlsoda* prob, const double rtol,
+                             const double atol, const double hmax,
+                             const double tdist) {
+  double d0 = 0.0, d1 = 0.0;
+  for(int i = 0; i < N; ++i) {
+    double sk = atol + rtol*std::fabs(Yn[i]);
+    d0 += (Yn[i]/sk)*(Yn[i]/sk);
+    d1 += (Fn[i]/sk)*(Fn[i]/sk);
+  }
+  d0 = std::sqrt(d0/N);
+  d1 = std::sqrt(d1/N);
+
+  double h0 = (d0 < 1.0E-5 || d1 < 1.0E-5) ? 1.0E-6 : 0.01*d0/d1;
+  if(tdist > 0.0) h0 = std::min(h0, tdist);
+
+  for(int i = 0; i < N; ++i) Ynew[i] = Yn[i] + h0*Fn[i];
+  double t1 = Tn + h0;
+  prob->call_derivs(&N, &t1, &Ynew[0], &Fnew[0]);
+  ++Nfe;
+
+  double d2 = 0.0;
+  for(int i = 0; i < N; ++i) {
+    double sk = atol + rtol*std::fabs(Yn[i]);
+    double e = (Fnew[i] - Fn[i])/sk;
+    d2 += e*e;
+  }
+  d2 = std::sqrt(d2/N)/h0;
+
+  double dm = std::max(d1, d2);
+  double h1 = dm <= 1.0E-15 ? std::max(1.0E-6, h0*1.0E-3) :
+    std::pow(0.01/dm, 1.0/static_cast<double>(order()));
+
+  double h = std::min(100.0*h0, h1);
+  if(hmax > 0.0) h = std::min(h, hmax);
+  return h;
+}
+
+/**
+ * Weighted root-mean-square norm of a local error estimate.
+ *
+ * @return a value less than or equal to 1 when the step passes
+ */
+double onestep::error_norm(const std::vector<double>& e, const double rtol,
+                           const double atol) const {
+  double sum = 0.0;
+  for(int i = 0; i < N; ++i) {
+    double sk = atol + rtol*std::max(std::fabs(Yn[i]), std::fabs(Ynew[i]));
+    double r = e[i]/sk;
+    sum += r*r;
+  }
+  return std::sqrt(sum/N);
+}
+
+// Dormand-Prince 5(4) coefficients
+#define DP_C2 (1.0/5.0)
+#define DP_C3 (3.0/10.0)
+#define DP_C4 (4.0/5.0)
+#define DP_C5 (8.0/9.0)
+#define DP_A21 (1.0/5.0)
+#define DP_A31 (3.0/40.0)
+#define DP_A32 (9.0/40.0)
+#define DP_A41 (44.0/45.0)
+#define DP_A42 (-56.0/15.0)
+#define DP_A43 (32.0/9.0)
+#define DP_A51 (19372.0/6561.0)
+#define DP_A52 (-25360.0/2187.0)
+#define DP_A53 (64448.0/6561.0)
+#define DP_A54 (-212.0/729.0)
+#define DP_A61 (9017.0/3168.0)
+#define DP_A62 (-355.0/33.0)
+#define DP_A63 (46732.0/5247.0)
+#define DP_A64 (49.0/176.0)
+#define DP_A65 (-5103.0/18656.0)
+#define DP_A71 (35.0/384.0)
+#define DP_A73 (500.0/1113.0)
+#define DP_A74 (125.0/192.0)
+#define DP_A75 (-2187.0/6784.0)
+#define DP_A76 (11.0/84.0)
+#define DP_E1 (71.0/57600.0)
+#define DP_E3 (-71.0/16695.0)
+#define DP_E4 (71.0/1920.0)
+#define DP_E5 (-17253.0/339200.0)
+#define DP_E6 (22.0/525.0)
+#define DP_E7 (-1.0/40.0)
+#define DP_D1 (-12715105075.0/11282082432.0)
+#define DP_D3 (87487479700.0/32700410799.0)
+#define DP_D4 (-10690763975.0/1880347072.0)
+#define DP_D5 (701980252875.0/199316789632.0)
+#define DP_D6 (-1453857185.0/822651844.0)
+#define DP_D7 (69997945.0/29380423.0)
+
+rk45::rk45(int neq_) : onestep(neq_) {
+  int n = std::max(neq_,1);
+  K2.assign(n, 0.0);
+  K3.assign(n, 0.0);
+  K4.assign(n, 0.0);
+  K5.assign(n, 0.0);
+  K6.assign(n, 0.0);
+  Ytmp.assign(n, 0.0);
+  Cont.assign(5*n, 0.0);
+}
+
+/**
+ * One trial step from <code>Tn</code>; the first stage is <code>Fn</code>
+ * and the last stage is left in <code>Fnew</code>.
+ */
+double rk45::attempt(odepack_dlsoda* prob, const double h, const double rtol,
+                     const double atol, const int /*jt*/) {
+  const double* k1 = &Fn[0];
+  double tt;
+
+  for(int i = 0; i < N; ++i) {
+    Ytmp[i] = Yn[i] + h*DP_A21*k1[i];
+  }
+  tt = Tn + DP_C2*h;
+  prob->call_derivs(&N, &tt, &Ytmp[0], &K2[0]);
+
+  for(int i = 0; i < N; ++i) {
+    Ytmp[i] = Yn[i] + h*(DP_A31*k1[i] + DP_A32*K2[i]);
+  }
+  tt = Tn + DP_C3*h;
+  prob->call_derivs(&N, &tt, &Ytmp[0], &K3[0]);
+
+  for(int i = 0; i < N; ++i) {
+    Ytmp[i] = Yn[i] + h*(DP_A41*k1[i] + DP_A42*K2[i] + DP_A43*K3[i]);
+  }
+  tt = Tn + DP_C4*h;
+  prob->call_derivs(&N, &tt, &Ytmp[0], &K4[0]);
+
+  for(int i = 0; i < N; ++i) {
+    Ytmp[i] = Yn[i] + h*(DP_A51*k1[i] + DP_A52*K2[i] + DP_A53*K3[i] +
+      DP_A54*K4[i]);
+  }
+  tt = Tn + DP_C5*h;
+  prob->call_derivs(&N, &tt, &Ytmp[0], &K5[0]);
+
+  for(int i = 0; i < N; ++i) {
+    Ytmp[i] = Yn[i] + h*(DP_A61*k1[i] + DP_A62*K2[i] + DP_A63*K3[i] +
+      DP_A64*K4[i] + DP_A65*K5[i]);
+  }
+  tt = Tn + h;
+  prob->call_derivs(&N, &tt, &Ytmp[0], &K6[0]);
+
+  for(int i = 0; i < N; ++i) {
+    Ynew[i] = Yn[i] + h*(DP_A71*k1[i] + DP_A73*K3[i] + DP_A74*K4[i] +
+      DP_A75*K5[i] + DP_A76*K6[i]);
+  }
+  prob->call_derivs(&N, &tt, &Ynew[0], &Fnew[0]);
+  Nfe += 6;
+
+  for(int i = 0; i < N; ++i) {
+    Err[i] = h*(DP_E1*k1[i] + DP_E3*K3[i] + DP_E4*K4[i] + DP_E5*K5[i] +
+      DP_E6*K6[i] + DP_E7*Fnew[i]);
+  }
+  return error_norm(Err, rtol, atol);
+}
+
+void rk45::accept() {
+  for(int i = 0; i < N; ++i) {
+    double ydiff = Ynew[i] - Yn[i];
+    double bspl = Hu*Fn[i] - ydiff;
+    Cont[i] = Yn[i];
+    Cont[N+i] = ydiff;
+    Cont[2*N+i] = bspl;
+    Cont[3*N+i] = ydiff - Hu*Fnew[i] - bspl;
+    Cont[4*N+i] = Hu*(DP_D1*Fn[i] + DP_D3*K3[i] + DP_D4*K4[i] +
+      DP_D5*K5[i] + DP_D6*K6[i] + DP_D7*Fnew[i]);
+  }
+  Yn.swap(Ynew);
+  Fn.swap(Fnew);
+}
+
+void rk45::interpolate(const double t, double* y) const {
+  const double s = (t - Told)/Hu;
+  const double s1 = 1.0 - s;
+  for(int i = 0; i < N; ++i) {
+    y[i] = Cont[i] + s*(Cont[N+i] + s1*(Cont[2*N+i] + s*(Cont[3*N+i] +
+      s1*Cont[4*N+i])));
+  }
+}
+
+// ode23s coefficients
+#define RB_D (1.0/(2.0 + 1.4142135623730951))
+#define RB_E32 (6.0 + 1.4142135623730951)
+
+rosenbrock::rosenbrock(int neq_) : onestep(neq_) {
+  int n = std::max(neq_,1);
+  J.assign(n*n, 0.0);
+  W.assign(n*n, 0.0);
+  Dfdt.assign(n, 0.0);
+  Piv.assign(n, 0);
+  K1.assign(n, 0.0);
+  K2.assign(n, 0.0);
+  K3.assign(n, 0.0);
+  F1.assign(n, 0.0);
+  Ytmp.assign(n, 0.0);
+  Y0.assign(n, 0.0);
+  D1.assign(n, 0.0);
+  D2.assign(n, 0.0);
+  Jcur = false;
+}
+
+void rosenbrock::start(odepack_dlsoda* /*prob*/) {
+  Jcur = false;
+}
+
+/**
+ * One trial step from <code>Tn</code>.  The Jacobian is computed at the
+ * first attempt from <code>Tn</code> and kept when the step is rejected.
+ */
+double rosenbrock::attempt(odepack_dlsoda* prob, const double h,
+                           const double rtol, const double atol,
+                           const int jt) {
+  if(!Jcur) {
+    jacobian(prob, rtol, atol, jt);
+    Jcur = true;
+  }
+
+  const double hd = h*RB_D;
+  for(int k = 0; k < N*N; ++k) W[k] = -hd*J[k];
+  for(int i = 0; i < N; ++i) W[i + i*N] += 1.0;
+  if(!factor()) return DBL_MAX*2.0;
+
+  for(int i = 0; i < N; ++i) K1[i] = Fn[i] + hd*Dfdt[i];
+  solve(&K1[0]);
+
+  for(int i = 0; i < N; ++i) Ytmp[i] = Yn[i] + 0.5*h*K1[i];
+  double tt = Tn + 0.5*h;
+  prob->call_derivs(&N, &tt, &Ytmp[0], &F1[0]);
+
+  for(int i = 0; i < N; ++i) K2[i] = F1[i] - K1[i];
+  solve(&K2[0]);
+  for(int i = 0; i < N; ++i) {
+    K2[i] += K1[i];
+    Ynew[i] = Yn[i] + h*K2[i];
+  }
+  tt = Tn + h;
+  prob->call_derivs(&N, &tt, &Ynew[0], &Fnew[0]);
+  Nfe += 2;
+
+  for(int i = 0; i < N; ++i) {
+    K3[i] = Fnew[i] - RB_E32*(K2[i] - F1[i]) - 2.0*(K1[i] - Fn[i]) +
+      hd*Dfdt[i];
+  }
+  solve(&K3[0]);
+
+  for(int i = 0; i < N; ++i) {
+    Err[i] = h/6.0*(K1[i] - 2.0*K2[i] + K3[i]);
+  }
+  return error_norm(Err, rtol, atol);
+}
+
+void rosenbrock::accept() {
+  Y0.swap(Yn);
+  D1.swap(K1);
+  D2.swap(K2);
+  Yn.swap(Ynew);
+  Fn.swap(Fnew);
+  Jcur = false;
+}
+
+void rosenbrock::interpolate(const double t, double* y) const {
+  const double s = (t - Told)/Hu;
+  const double a = s*(1.0 - s)/(1.0 - 2.0*RB_D);
+  const double b = s*(s - 2.0*RB_D)/(1.0 - 2.0*RB_D);
+  for(int i = 0; i < N; ++i) {
+    y[i] = Y0[i] + Hu*(a*D1[i] + b*D2[i]);
+  }
+}
+
+/**
+ * The Jacobian and the time derivative of the derivatives at
+ * <code>Tn</code>.  With <code>jt = 1</code> the Jacobian comes from
+ * <code>call_jac</code>; otherwise from forward differences.  Uses
+ * <code>Fnew</code> as scratch.
+ */
+void rosenbrock::jacobian(odepack_dlsoda* prob, const double rtol,
+                          const double atol, const int jt) {
+  const double srur = std::sqrt(DBL_EPSILON);
+  if(jt == 1) {
+    std::fill(J.begin(), J.end(), 0.0);
+    prob->call_jac(&N, &Tn, &Yn[0], &J[0]);
+  } else {
+    const double floor = rtol > 0.0 ? atol/rtol : 1.0;
+    for(int i = 0; i < N; ++i) Ytmp[i] = Yn[i];
+    for(int j = 0; j < N; ++j) {
+      double del = srur*std::max(std::fabs(Yn[j]), floor);
+      if(del == 0.0) del = srur;
+      Ytmp[j] = Yn[j] + del;
+      del = Ytmp[j] - Yn[j];
+      prob->call_derivs(&N, &Tn, &Ytmp[0], &Fnew[0]);
+      for(int i = 0; i < N; ++i) {
+        J[i + j*N] = (Fnew[i] - Fn[i])/del;
+      }
+      Ytmp[j] = Yn[j];
+    }
+    Nfe += N;
+  }
+  ++Nje;
+
+  double tdel = srur*std::max(std::fabs(Tn), std::fabs(H));
+  if(tdel == 0.0) tdel = srur;
+  double tt = Tn + tdel;
+  tdel = tt - Tn;
+  prob->call_derivs(&N, &tt, &Yn[0], &Fnew[0]);
+  ++Nfe;
+  for(int i = 0; i < N; ++i) {
+    Dfdt[i] = (Fnew[i] - Fn[i])/tdel;
+  }
+}
+
+/**
+ * LU factorization of <code>W</code> in place, with partial pivoting.
+ *
+ * @return false if <code>W</code> is singular
+ */
+bool rosenbrock::factor() {
+  return lu_factor(&W[0], &Piv[0], N);
+}
+
+/**
+ * Solve <code>W x = b</code> with the factors from <code>factor</code>;
+ * <code>b</code> is overwritten with <code>x</code>.
+ */
+void rosenbrock::solve(double* b) const {
+  lu_solve(&W[0], &Piv[0], N, b);
+}
+
+//! number of step sizes kept in the <code>linear</code> cache
+#define LINEAR_CACHE 8
+
+linear::linear(int neq_) {
+  N = neq_;
+  int n = std::max(neq_,1);
+  Tn = 0.0;
+  Told = 0.0;
+  Hu = 0.0;
+  Yn.assign(n, 0.0);
+  Y0.assign(n, 0.0);
+  K.assign(n*n, 0.0);
+  B.assign(n, 0.0);
+  Ytmp.assign(n, 0.0);
+  Ftmp.assign(n, 0.0);
+  Cache_next = 0;
+  A.assign(4*n*n, 0.0);
+  X.assign(4*n*n, 0.0);
+  P.assign(4*n*n, 0.0);
+  Q.assign(4*n*n, 0.0);
+  T.assign(4*n*n, 0.0);
+  Piv.assign(2*n, 0);
+  Nst = 0;
+  Nfe = 0;
+  Nexp = 0;
+  Started = false;
+}
+
+/**
+ * Advance the solution to <code>tout</code>.
+ *
+ * See <code>integrator</code> for the arguments.  <code>rtol</code>, 
+ * <code>atol</code> and <code>jt</code> aren't used; the solution is exact
+ * up to rounding.  A call that only interpolates inside the last step 
+ * propagates from the start of that step with the same rate matrix.
+ */
+void linear::run(odepack_dlsoda* prob, double* y, double& t,
+                 const double& tout, const double& /*rtol*/, 
+                 const double& /*atol*/, const int itask, int& istate, 
+                 const int iopt, double* rwork, int* iwork, 
+                 const int /*jt*/) {
+
+  messages.clear();
+  aborted = false;
+
+  if(istate < 0) {
+    messages.push_back("Run aborted.. apparent infinite loop.");
+    aborted = true;
+    return;
+  }
+
+  if(istate < 1 || istate > 2 || itask < 1 || itask > 5 || itask == 3 ||
+     (istate == 2 && !Started)) {
+    std::stringstream ss;
+    ss << "illegal input: istate = " << istate << ", itask = " << itask;
+    messages.push_back(ss.str());
+    istate = -3;
+    return;
+  }
+
+  int mxstep = 500;
+  double hmax = 0.0;
+  if(iopt == 1) {
+    if(iwork[5] > 0) mxstep = iwork[5];
+    if(rwork[5] > 0.0) hmax = rwork[5];
+  }
+
+  const bool stop = itask == 4 || itask == 5;
+  const bool one = itask == 2 || itask == 5;
+  const double tcrit = rwork[0];
+  if(stop && tcrit < tout) {
+    messages.push_back("itask = 4 or 5 and tcrit is behind tout.");
+    istate = -3;
+    return;
+  }
+
+  if(istate == 1) {
+    Nst = 0;
+    Nfe = 0;
+    Nexp = 0;
+    Tn = t;
+    Told = t;
+    Hu = 0.0;
+    for(int i = 0; i < N; ++i) Yn[i] = y[i];
+    Started = true;
+  }
+
+  if(tout < Told) {
+    std::stringstream ss;
+    ss << "tout (= " << tout << ") is behind the current step.";
+    messages.push_back(ss.str());
+    istate = -3;
+    return;
+  }
+
+  if(!one && tout <= Tn && istate == 2) {
+    // Inside the last step
+    if(tout == Tn) {
+      for(int i = 0; i < N; ++i) y[i] = Yn[i];
+    } else {
+      propagate(tout - Told, &Y0[0], y);
+    }
+    t = tout;
+  } else {
+    if(!rate_matrix(prob)) {
+      nonlinear(y, t, istate);
+      return;
+    }
+    int nstep = 0;
+    while(Tn < tout) {
+      if(nstep >= mxstep) {
+        std::stringstream ss;
+        ss << "at t (= " << Tn << "), mxstep (= " << mxstep
+           << ") steps taken before reaching tout.";
+        messages.push_back(ss.str());
+        istate = -1;
+        break;
+      }
+      double h = tout - Tn;
+      double tnew = tout;
+      if(hmax > 0.0 && h > hmax) {
+        h = hmax;
+        tnew = Tn + h;
+      }
+      if(stop && Tn + h > tcrit) {
+        h = tcrit - Tn;
+        tnew = tcrit;
+      }
+      if(h <= 0.0) break;
+      Y0.swap(Yn);
+      propagate(h, &Y0[0], &Yn[0]);
+      Told = Tn;
+      Tn = tnew;
+      Hu = h;
+      ++Nst;
+      ++nstep;
+      if(one) break;
+    }
+    // K and b have to hold where the solution ended up as well
+    if(nstep > 0 && !fits(prob, &Yn[0])) {
+      nonlinear(y, t, istate);
+      return;
+    }
+    for(int i = 0; i < N; ++i) y[i] = Yn[i];
+    t = Tn;
+  }
+  if(istate > 0) istate = 2;
+
+  rwork[10] = Hu;
+  rwork[11] = Hu;
+  rwork[12] = Tn;
+  iwork[10] = Nst;
+  iwork[11] = Nfe;
+  iwork[12] = Nexp;
+}
+
+/**
+ * Find <code>K</code> and <code>b</code> at <code>Tn</code>: 
+ * <code>b</code> is the derivatives at zero amounts and column 
+ * <code>j</code> of <code>K</code> is the change in the derivatives for a 
+ * unit amount in compartment <code>j</code>.  The cache is cleared when
+ * <code>K</code> changes.
+ *
+ * @return false if the derivatives at <code>Yn</code> or at a second 
+ * point away from <code>Yn</code> don't match <code>K y + b</code>
+ */
+bool linear::rate_matrix(odepack_dlsoda* prob) {
+  std::fill(Ytmp.begin(), Ytmp.end(), 0.0);
+  prob->call_derivs(&N, &Tn, &Ytmp[0], &B[0]);
+  for(int j = 0; j < N; ++j) {
+    Ytmp[j] = 1.0;
+    prob->call_derivs(&N, &Tn, &Ytmp[0], &K[j*N]);
+    for(int i = 0; i < N; ++i) K[i + j*N] -= B[i];
+    Ytmp[j] = 0.0;
+  }
+  Nfe += N + 1;
+
+  if(!fits(prob, &Yn[0])) return false;
+
+  // Yn alone doesn't show curvature when it is 0 or a unit amount, 
+  // where K came from; so check again at Yn + (1 + |Yn|)/2
+  for(int j = 0; j < N; ++j) {
+    Ytmp[j] = Yn[j] + 0.5*(1.0 + std::fabs(Yn[j]));
+  }
+  if(!fits(prob, &Ytmp[0])) return false;
+
+  if(K != Kc) {
+    Kc = K;
+    Cache_h.clear();
+    Cache.clear();
+    Cache_next = 0;
+  }
+  return true;
+}
+
+/**
+ * Check the model against <code>K y + b</code> at <code>y</code> and 
+ * <code>Tn</code>.  Only the model equations are checked; anything 
+ * integrated along with them (sensitivities) is linear when the model is.
+ *
+ * @return false if the derivatives at <code>y</code> don't match
+ */
+bool linear::fits(odepack_dlsoda* prob, double* y) {
+  prob->call_derivs(&N, &Tn, y, &Ftmp[0]);
+  ++Nfe;
+  const int neq = std::min(N, prob->neq());
+  for(int i = 0; i < neq; ++i) {
+    double f = B[i];
+    double scale = std::fabs(B[i]) + std::fabs(Ftmp[i]);
+    for(int j = 0; j < N; ++j) {
+      f += K[i + j*N]*y[j];
+      scale += std::fabs(K[i + j*N]*y[j]);
+    }
+    if(std::fabs(Ftmp[i] - f) > 1.0E-6*scale) return false;
+  }
+  return true;
+}
+
+/**
+ * Stop with an error for a model that isn't linear; <code>y</code> and 
+ * <code>t</code> are set to where the solver got to.
+ */
+void linear::nonlinear(double* y, double& t, int& istate) {
+  std::stringstream ss;
+  ss << "at t (= " << Tn << "), the model is not linear in the "
+     << "compartment amounts; the expm solver can't be used.";
+  messages.push_back(ss.str());
+  for(int i = 0; i < N; ++i) y[i] = Yn[i];
+  t = Tn;
+  istate = -3;
+  Started = false;
+}
+
+/**
+ * <code>y = exp(K h) y0 + G(h) b</code>; the matrices come from the cache 
+ * when they were already computed for <code>h</code>.
+ */
+void linear::propagate(const double h, const double* y0, double* y) {
+  int slot = -1;
+  for(size_t k = 0; k < Cache_h.size(); ++k) {
+    if(Cache_h[k] == h) {
+      slot = k;
+      break;
+    }
+  }
+  if(slot < 0) {
+    if(Cache_h.size() < LINEAR_CACHE) {
+      Cache_h.push_back(h);
+      Cache.push_back(std::vector<double>(2*N*N + 1, 0.0));
+      slot = Cache_h.size() - 1;
+    } else {
+      slot = Cache_next;
+      Cache_next = (Cache_next + 1) % LINEAR_CACHE;
+      Cache_h[slot] = h;
+    }
+    exponential(h, &Cache[slot][0], &Cache[slot][N*N]);
+    ++Nexp;
+  }
+  const double* phi = &Cache[slot][0];
+  const double* gam = &Cache[slot][N*N];
+  for(int i = 0; i < N; ++i) y[i] = 0.0;
+  for(int j = 0; j < N; ++j) {
+    const double a = y0[j];
+    const double c = B[j];
+    for(int i = 0; i < N; ++i) {
+      y[i] += phi[i + j*N]*a + gam[i + j*N]*c;
+    }
+  }
+}
+
+static void matmul(const double* a, const double* b, double* c, 
+                   const int n) {
+  for(int k = 0; k < n*n; ++k) c[k] = 0.0;
+  for(int j = 0; j < n; ++j) {
+    for(int l = 0; l < n; ++l) {
+      const double w = b[l + j*n];
+      if(w == 0.0) continue;
+      for(int i = 0; i < n; ++i) {
+        c[i + j*n] += a[i + l*n]*w;
+      }
+    }
+  }
+}
+
+/**
+ * <code>exp(K h)</code> and <code>G(h)</code> from the exponential of 
+ * <code>[K h, I h; 0, 0]</code>, which is <code>[exp(K h), G(h); 0, I]</code>.
+ * The exponential is the diagonal Pade approximant of degree 6 with 
+ * scaling and squaring (Moler and Van Loan, 2003, method 3).
+ */
+void linear::exponential(const double h, double* phi, double* gam) {
+  const int m = 2*N;
+  const int q = 6;
+  std::fill(A.begin(), A.end(), 0.0);
+  for(int j = 0; j < N; ++j) {
+    for(int i = 0; i < N; ++i) {
+      A[i + j*m] = K[i + j*N]*h;
+    }
+    A[j + (N+j)*m] = h;
+  }
+
+  double norm = 0.0;
+  for(int i = 0; i < m; ++i) {
+    double row = 0.0;
+    for(int j = 0; j < m; ++j) row += std::fabs(A[i + j*m]);
+    norm = std::max(norm, row);
+  }
+  int s = 0;
+  if(norm > 0.5 && norm <= DBL_MAX) {
+    int e = 0;
+    std::frexp(norm, &e);
+    s = e + 1;
+    const double scale = std::ldexp(1.0, -s);
+    for(int k = 0; k < m*m; ++k) A[k] *= scale;
+  }
+
+  double c = 0.5;
+  for(int k = 0; k < m*m; ++k) {
+    X[k] = A[k];
+    P[k] = c*A[k];
+    Q[k] = -c*A[k];
+  }
+  for(int i = 0; i < m; ++i) {
+    P[i + i*m] += 1.0;
+    Q[i + i*m] += 1.0;
+  }
+  for(int k = 2; k <= q; ++k) {
+    c = c*(q - k + 1)/(k*(2*q - k + 1));
+    matmul(&A[0], &X[0], &T[0], m);
+    X.swap(T);
+    const double cq = k % 2 == 0 ? c : -c;
+    for(int l = 0; l < m*m; ++l) {
+      P[l] += c*X[l];
+      Q[l] += cq*X[l];
+    }
+  }
+  lu_factor(&Q[0], &Piv[0], m);
+  for(int j = 0; j < m; ++j) lu_solve(&Q[0], &Piv[0], m, &P[j*m]);
+  for(int k = 0; k < s; ++k) {
+    matmul(&P[0], &P[0], &T[0], m);
+    P.swap(T);
+  }
+
+  for(int j = 0; j < N; ++j) {
+    for(int i = 0; i < N; ++i) {
+      phi[i + j*N] = P[i + j*m];
+      gam[i + j*N] = P[i + (N+j)*m];
+    }
+  }
+}
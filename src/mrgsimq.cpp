@@ -34,20 +34,15 @@
 
 
 
-#include <boost/shared_ptr.hpp>
-#include <boost/pointer_cast.hpp>
 #include <string>
 #include "mrgsolve.h"
 #include "odeproblem.h"
 #include "dataobject.h"
+#include "simrun.h"
 #include "RcppInclude.h"
 
 
 #define CRUMP(a) throw Rcpp::exception(a,false)
-#define REP(a)   Rcpp::Rcout << #a << std::endl;
-#define nREP(a)  Rcpp::Rcout << a << std::endl;
-#define say(a)   Rcpp::Rcout << a << std::endl;
-#define __ALAG_POS -1200
 
 
 
@@ -92,9 +87,6 @@ Rcpp::NumericMatrix MRGSIMQ(const Rcpp::List parin,
   // Number of individuals in the data set
   const int NID = dat.nid();
   
-  unsigned int k = 0;
-  unsigned int crow = 0;
-  
   bool put_ev_first = false;
   bool addl_ev_first = true;
   
@@ -132,11 +124,12 @@ Rcpp::NumericMatrix MRGSIMQ(const Rcpp::List parin,
   prob->pass_envir(&envir);
   const unsigned int neq = prob->neq();
   
+  recpool pool;
   recstack a(NID);
   
   unsigned int obscount = 0;
   unsigned int evcount = 0;
-  dat.get_records(a, NID, neq, obscount, evcount, false, false);
+  dat.get_records(a, pool, NID, neq, obscount, evcount, false, false);
   
   bool obsaug = false;
   
@@ -153,7 +146,7 @@ Rcpp::NumericMatrix MRGSIMQ(const Rcpp::List parin,
     observations.reserve(n);
     
     for(size_t j = 0; j < n; ++j) {
-      rec_ptr obs = NEWREC(stime[j],nextpos,true);
+      rec_ptr obs = pool.make(stime[j],nextpos,true);
       observations.push_back(obs);
     }
     
@@ -182,250 +175,54 @@ Rcpp::NumericMatrix MRGSIMQ(const Rcpp::List parin,
   const unsigned int req_start = precol;
   const unsigned int capture_start = req_start + nreq;
   
+  // ETA are either drawn here from the R random number generator or 
+  // drawn per subject from streams keyed on stream_seed.  EPS are drawn 
+  // as they are needed, from the streams with stream_seed and from the R 
+  // random number generator without it.
+  int stream_seed = Rcpp::as<int>(parin["stream_seed"]);
+  const bool streaming = stream_seed != NA_INTEGER;
+  
   const unsigned int neta = OMEGA.nrow();
   arma::mat eta;
   if(neta > 0) {
-    eta = prob->mv_omega(NID);
+    if(!streaming) eta = prob->mv_omega(NID);
     prob->neta(neta);
   }
   
   const unsigned int neps = SIGMA.nrow();
-  arma::mat eps;
   if(neps > 0) {
-    eps = prob->mv_sigma(NN);
     prob->neps(neps);
   }
   
-  double tto, tfrom;
-  crow = 0;
-  int this_cmtn = 0;
-  double dt = 0;
-  double id = 0;
-  double maxtime = 0;
-  double Fn = 1.0;
-  
-  prob->nid(dat.nid());
-  prob->nrow(NN);
-  prob->idn(0);
-  prob->rown(0);
-  
-  prob->config_call();
-  reclist mtimehx;
-  // i is indexing the subject, j is the record
-  
-  // LOOP ACROSS IDS:
-  // tgrid observations have generic ID
-  // We must first figure out the ID we are working with
-  // and assign in the object
-  for(size_t i=0; i < a.size(); ++i) {
-
-    prob->idn(i);
-    
-    tfrom = a[i].front()->time();
-    maxtime = a[i].back()->time();
-    
-    id = dat.get_uid(i);
-    
-    prob->reset_newid(id);
-    
-    if(i==0) {
-      prob->newind(0);
-    }
-    
-    for(k=0; k < neta; ++k) prob->eta(k,eta(i,k));
-    for(k=0; k < neps; ++k) prob->eps(k,eps(crow,k));
-    
-    if(a[i][0]->from_data()) {
-      dat.copy_parameters(a[i][0]->pos(), prob);
-    }
-    
-    prob->y_init(init);
-    
-    prob->set_d(a[i][0]);
-    prob->init_call(tfrom);
-    
-    for(size_t j=0; j < a[i].size(); ++j) {
-      
-      if(crow == NN) continue;
-      
-      prob->rown(crow);
-      
-      rec_ptr this_rec = a[i][j];
-      
-      this_rec->id(id);
-      
-      if(prob->systemoff()) {
-        unsigned short int status = prob->systemoff();
-        if(status==9) CRUMP("the problem was stopped at user request.");
-        if(status==999) CRUMP("999 sent from the model");
-        if(this_rec->output()) {
-          if(status==1) {
-            ans(crow,0) = this_rec->id();
-            ans(crow,1) = this_rec->time();
-            for(unsigned int k=0; k < n_capture; ++k) {
-              ans(crow,(k+capture_start)) = prob->capture(capture[k+1]);
-            }
-            for(unsigned int k=0; k < nreq; ++k) {
-              ans(crow,(k+req_start)) = prob->y(request[k]);
-            }
-          } else {
-            for(int k=0; k < ans.ncol(); ++k) {
-              ans(crow,k) = NA_REAL;
-            }
-          }
-          ++crow;
-        }
-        continue;
-      }
-      
-      if(this_rec->from_data()) {
-        dat.copy_parameters(this_rec->pos(), prob);
-      }
-      
-      tto = this_rec->time();
-      
-      dt  = (tto-tfrom)/(tfrom == 0.0 ? 1.0 : tfrom);
-      
-      if((dt > 0.0) && (dt < mindt)) {
-        tto = tfrom;
-      }
-      
-      if(tto > tfrom) {
-        for(k = 0; k < neps; ++k) {
-          prob->eps(k,eps(crow,k));
-        }
-      }
-      
-      if(j != 0) {
-        prob->newind(2);
-        prob->set_d(this_rec);
-        prob->init_call_record(tto);
-      }
-      
-      
-      // Some non-observation event happening
-      if(this_rec->is_event()) {
-        
-        this_cmtn = this_rec->cmtn();
-        
-        Fn = prob->fbio(this_cmtn);
-        
-        if(Fn < 0) {
-          CRUMP("mrgsolve: bioavailability fraction is less than zero.");
-        }
-        
-        bool sort_recs = false;
-        
-        if(this_rec->from_data()) {
-          
-          if(this_rec->rate() < 0) {
-            prob->rate_main(this_rec);
-          }
-          
-          if(prob->alag(this_cmtn) > mindt) { // there is a valid lagtime
-            if(this_rec->ss() > 0) {
-              this_rec->steady(prob, Fn);
-            }
-            rec_ptr newev = NEWREC(*this_rec);
-            newev->pos(__ALAG_POS);
-            newev->phantom_rec();
-            newev->time(this_rec->time() + prob->alag(this_cmtn));
-            newev->ss(0);
-            reclist::iterator it = a[i].begin()+j;
-            advance(it,1);
-            a[i].insert(it,newev);
-            newev->schedule(a[i], maxtime, addl_ev_first, Fn);
-            this_rec->unarm();
-            sort_recs = true;
-          } else { // no valid lagtime
-            this_rec->schedule(a[i], maxtime, addl_ev_first, Fn);
-            sort_recs = this_rec->needs_sorting();
-          }
-        } // from data
-        
-        // This block gets hit for any and all infusions; sometimes the
-        // infusion just got started and we need to add the lag time
-        // sometimes it is an infusion via addl and lag time is already there
-        if(this_rec->int_infusion() && this_rec->armed()) {
-          rec_ptr evoff = NEWREC(this_rec->cmt(),
-                                 9,
-                                 this_rec->amt(),
-                                 this_rec->time() + this_rec->dur(Fn),
-                                 this_rec->rate(),
-                                 -299,
-                                 this_rec->id());
-          if(this_rec->from_data()) {
-            evoff->time(evoff->time() + prob->alag(this_cmtn));
-          }
-          a[i].push_back(evoff);
-          sort_recs = true;
-        }
-        
-        // SORT
-        if(sort_recs) {
-          std::sort(a[i].begin()+j+1,a[i].end(),CompRec());
-        }
-      } // is_dose
-      
-      prob->advance(tfrom,tto);
-      
-      if(this_rec->evid() != 2) {
-        this_rec->implement(prob);
-      }
-      
-      prob->table_call();
-      
-      if(prob->any_mtime()) {
-        if(prob->newind() <=1) mtimehx.clear();  
-        std::vector<mrgsolve::evdata> mt  = prob->mtimes();
-        for(size_t mti = 0; mti < mt.size(); ++mti) {
-          double this_time = (mt[mti]).time;
-          if(this_time < tto) continue;
-          unsigned int this_evid = (mt[mti]).evid;
-          double this_amt = mt[mti].amt;
-          int this_cmt = (mt[mti]).cmt;
-          if(neq!=0 && this_evid !=0) {
-            if((this_cmt == 0) || (abs(this_cmt) > int(neq))) {
-              Rcpp::Rcout << this_cmt << std::endl;
-              CRUMP("Compartment number in modeled event out of range.");
-            }
-          }
-          rec_ptr new_ev = NEWREC(this_cmt,this_evid,this_amt,this_time,0.0);
-          new_ev->phantom_rec();
-          if(mt[mti].now) {
-            new_ev->implement(prob);
-          } else {
-            bool foo = CompEqual(mtimehx,this_time,this_evid,this_cmt);
-            if(!foo) {
-              a[i].push_back(new_ev);
-              std::sort(a[i].begin()+j+1,a[i].end(),CompRec());
-              mtimehx.push_back(new_ev);
-            } 
-          }
-        }
-        prob->clear_mtime();
-      }
-      
-      
-      if(this_rec->output()) {
-        ans(crow,0) = this_rec->id();
-        ans(crow,1) = this_rec->time();
-        
-        k = 0;
-        for(unsigned int i=0; i < n_capture; ++i) {
-          ans(crow,k+capture_start) = prob->capture(capture[i+1]);
-          ++k;
-        }
-        for(k=0; k < nreq; ++k) {
-          ans(crow,(k+req_start)) = prob->y(request[k]);
-        }
-        ++crow;
-      } 
-      if(this_rec->evid()==2) {
-        this_rec->implement(prob);
-      }
-      tfrom = tto;
-    }
+  if(!streaming) stream_seed = 0;
+  prob->stream_seed(stream_seed, streaming, streaming);
+  
+  simrun sim(&dat, NULL, ans);
+  sim.tad = false;
+  sim.nocb = true;
+  sim.filbak = false;
+  sim.addl_ev_first = addl_ev_first;
+  sim.mindt = mindt;
+  sim.neq = neq;
+  sim.neta = neta;
+  sim.neps = neps;
+  sim.eta = eta;
+  sim.init.assign(init.begin(), init.end());
+  sim.capture(capture, capture_start);
+  sim.request(request, req_start);
+  sim.first_rows(a);
+  
+  std::vector<odeproblem*> probs(1, prob);
+  
+  std::string err;
+  try {
+    sim.run(a, probs);
+  } catch(mrgsolve_error& e) {
+    err = e.what();
+  }
+  if(err.size() > 0) {
+    delete prob;
+    CRUMP(err.c_str());
   }
   
   delete prob;
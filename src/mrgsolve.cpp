@@ -23,6 +23,7 @@
 
 #include "RcppInclude.h"
 #include "mrgsolve.h"
+#include "mvgauss.h"
 #include <vector>
 #include <string>
 #include "boost/tokenizer.hpp"
@@ -116,22 +117,8 @@ arma::mat MVGAUSS(Rcpp::NumericMatrix& OMEGA_, int n) {
 }
 
 arma::mat MVGAUSS(arma::mat& OMEGA, int n) {
-  
-  arma::vec eigval;
-  arma::mat eigvec;
-  arma::eig_sym(eigval,eigvec, OMEGA);
-  
-  int ncol = OMEGA.n_cols;
-  
-  arma::mat X = arma::randn<arma::mat>(n,ncol);
-  
-  eigval = arma::sqrt(eigval);
-  
-  arma::mat Z = arma::diagmat(eigval);
-  
-  X = eigvec * Z * X.t();
-  
-  return X.t();
+  mvgauss mv(OMEGA);
+  return mv.draw(n);
 }
 
 //[[Rcpp::export]]
@@ -32,11 +32,17 @@ RcppExport SEXP _mrgsolve_SUPERMATRIX(SEXP,SEXP);
 RcppExport SEXP _mrgsolve_TOUCH_FUNS(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
 RcppExport SEXP _mrgsolve_EXPAND_EVENTS(SEXP,SEXP,SEXP);
 RcppExport SEXP _mrgsolve_EXPAND_OBSERVATIONS(SEXP,SEXP,SEXP);
+RcppExport SEXP _mrgsolve_SESSION_NEW(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,
+                                      SEXP,SEXP,SEXP,SEXP);
+RcppExport SEXP _mrgsolve_SESSION_RUN(SEXP,SEXP,SEXP);
+RcppExport SEXP _mrgsolve_SESSION_SWEEP(SEXP,SEXP,SEXP);
+RcppExport SEXP _mrgsolve_SESSION_FORK(SEXP,SEXP,SEXP,SEXP,SEXP);
 
 RcppExport void _model_housemodel_main__(MRGSOLVE_INIT_SIGNATURE);
 RcppExport void _model_housemodel_ode__(MRGSOLVE_ODE_SIGNATURE);
 RcppExport void _model_housemodel_table__(MRGSOLVE_TABLE_SIGNATURE);
 RcppExport void _model_housemodel_config__(MRGSOLVE_CONFIG_SIGNATURE);
+RcppExport void _model_housemodel_vars__(MRGSOLVE_VARS_SIGNATURE);
 
 static R_CallMethodDef callEntryPoints[]  = {
   CALLDEF(_mrgsolve_get_tokens,1),
@@ -47,11 +53,16 @@ static R_CallMethodDef callEntryPoints[]  = {
   CALLDEF(_mrgsolve_TOUCH_FUNS,7),
   CALLDEF(_mrgsolve_EXPAND_EVENTS,3),
   CALLDEF(_mrgsolve_EXPAND_OBSERVATIONS,3),
+  CALLDEF(_mrgsolve_SESSION_NEW,12),
+  CALLDEF(_mrgsolve_SESSION_RUN,3),
+  CALLDEF(_mrgsolve_SESSION_SWEEP,3),
+  CALLDEF(_mrgsolve_SESSION_FORK,5),
   CALLDEF(_mrgsolve_dcorr,1),
   CALLDEF(_model_housemodel_main__,MRGSOLVE_INIT_SIGNATURE_N),
   CALLDEF(_model_housemodel_ode__,MRGSOLVE_ODE_SIGNATURE_N),
   CALLDEF(_model_housemodel_table__,MRGSOLVE_TABLE_SIGNATURE_N),
   CALLDEF(_model_housemodel_config__,MRGSOLVE_CONFIG_SIGNATURE_N),
+  CALLDEF(_model_housemodel_vars__,MRGSOLVE_VARS_SIGNATURE_N),
   
   {NULL, NULL, 0}
 };
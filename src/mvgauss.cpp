@@ -0,0 +1,138 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file mvgauss.cpp
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "mvgauss.h"
+
+mvgauss::mvgauss(const arma::mat& x) : N(0) {
+  set(x);
+}
+
+/**
+ * Find the independent blocks in a variance/covariance matrix and factor
+ * each one.
+ *
+ * Each block is factored as <code>V * sqrt(D)</code> from its
+ * eigendecomposition, so that blocks with zero variance are handled.
+ *
+ * @param x a symmetric variance/covariance matrix
+ */
+void mvgauss::set(const arma::mat& x) {
+  N = x.n_rows;
+  Index.clear();
+  Factor.clear();
+
+  // Connected components of the graph with an edge wherever there is a
+  // nonzero covariance
+  std::vector<int> block(N, -1);
+  std::vector<unsigned int> stack;
+  int nb = 0;
+  for(unsigned int i = 0; i < N; ++i) {
+    if(block[i] >= 0) continue;
+    std::vector<unsigned int> members;
+    block[i] = nb;
+    stack.push_back(i);
+    while(!stack.empty()) {
+      unsigned int j = stack.back();
+      stack.pop_back();
+      members.push_back(j);
+      for(unsigned int k = 0; k < N; ++k) {
+        if(block[k] >= 0) continue;
+        if(x(j,k) != 0.0 || x(k,j) != 0.0) {
+          block[k] = nb;
+          stack.push_back(k);
+        }
+      }
+    }
+    std::sort(members.begin(), members.end());
+    Index.push_back(members);
+    ++nb;
+  }
+
+  for(size_t b = 0; b < Index.size(); ++b) {
+    const std::vector<unsigned int>& idx = Index[b];
+    const unsigned int nr = idx.size();
+    if(nr == 1) {
+      arma::mat L(1,1);
+      L(0,0) = std::sqrt(x(idx[0],idx[0]));
+      Factor.push_back(L);
+      continue;
+    }
+    arma::mat sub(nr,nr);
+    for(unsigned int j = 0; j < nr; ++j) {
+      for(unsigned int k = 0; k < nr; ++k) {
+        sub(j,k) = x(idx[j],idx[k]);
+      }
+    }
+    arma::vec eigval;
+    arma::mat eigvec;
+    arma::eig_sym(eigval, eigvec, sub);
+    eigval = arma::sqrt(eigval);
+    Factor.push_back(eigvec * arma::diagmat(eigval));
+  }
+}
+
+/**
+ * Draw from the multivariate normal distribution with the R random number
+ * generator.
+ *
+ * @param n the number of draws
+ * @return a matrix with one draw per row
+ */
+arma::mat mvgauss::draw(const int n) const {
+  arma::mat Z = arma::randn<arma::mat>(n, N);
+  arma::mat X(n, N);
+  for(size_t b = 0; b < Index.size(); ++b) {
+    const std::vector<unsigned int>& idx = Index[b];
+    const arma::mat& L = Factor[b];
+    for(int r = 0; r < n; ++r) {
+      for(size_t i = 0; i < idx.size(); ++i) {
+        double sum = 0.0;
+        for(size_t c = 0; c < idx.size(); ++c) {
+          sum += L(i,c) * Z(r,idx[c]);
+        }
+        X(r,idx[i]) = sum;
+      }
+    }
+  }
+  return X;
+}
+
+/**
+ * Transform standard normal deviates into one multivariate normal draw.
+ *
+ * @param z <code>size()</code> standard normal deviates
+ * @param x the result; <code>size()</code> values
+ */
+void mvgauss::apply(const double* z, double* x) const {
+  for(size_t b = 0; b < Index.size(); ++b) {
+    const std::vector<unsigned int>& idx = Index[b];
+    const arma::mat& L = Factor[b];
+    for(size_t i = 0; i < idx.size(); ++i) {
+      double sum = 0.0;
+      for(size_t c = 0; c < idx.size(); ++c) {
+        sum += L(i,c) * z[idx[c]];
+      }
+      x[idx[i]] = sum;
+    }
+  }
+}
@@ -22,21 +22,25 @@
  */
 
 #include "odepack_dlsoda.h"
-#include <algorithm>
+#include "dlsoda.h"
 
 odepack_dlsoda::odepack_dlsoda(int npar_, int neq_) {
 
   Npar = npar_;
   Neq = neq_;
+  Nsys = neq_;
+
+  Solver = new dlsoda(neq_);
+  Solver_type = MRGSOLVE_SOLVER_LSODA;
+  Nstep = 0;
+  Nrhs = 0;
+  Njac = 0;
 
   Y = new double[neq_]();
   Ydot = new double[neq_]();
 
-  xlrwork = std::max(int(20 + 16 * neq_),int(22 + 9  * neq_ + neq_ * neq_));
-  xliwork = 20 + neq_;
-
-  xrwork = new double[xlrwork];
-  xiwork = new int [xliwork];
+  xrwork = new double[20]();
+  xiwork = new int[20]();
 
   xrwork[0] = 0.0;
   xrwork[4] = 0.0;      // h0
@@ -63,6 +67,7 @@ odepack_dlsoda::odepack_dlsoda(int npar_, int neq_) {
 
 
 odepack_dlsoda::~odepack_dlsoda(){
+  delete Solver;
   delete [] Y;
   delete [] Ydot;
   delete [] xrwork;
@@ -76,4 +81,86 @@ void odepack_dlsoda::tol(double atol, double rtol) {
   xrtol = rtol;
 }
 
+/**
+ * Pick the ODE solver.  The solver is only replaced when the type 
+ * changes; the next call to <code>integrate</code> will start it.
+ * 
+ * @param type one of the <code>MRGSOLVE_SOLVER_</code> codes; anything 
+ * else selects <code>DLSODA</code>
+ */
+void odepack_dlsoda::solver(int type) {
+  if(type != MRGSOLVE_SOLVER_RK45 && type != MRGSOLVE_SOLVER_ROSENBROCK &&
+     type != MRGSOLVE_SOLVER_EXPM) {
+    type = MRGSOLVE_SOLVER_LSODA;
+  }
+  if(type == Solver_type) return;
+  Solver_type = type;
+  this->make_solver();
+}
+
+/**
+ * Set the number of equations the solver integrates.  The first 
+ * <code>Neq</code> are the state variables; anything after that is 
+ * integrated along with them (see <code>odeproblem::copy_parin</code>).  
+ * The state vector keeps the state variables and the rest starts at 
+ * zero; the solver is replaced and starts over on the next call.
+ * 
+ * @param n the number of equations; <code>Neq</code> or more
+ */
+void odepack_dlsoda::nsys(int n) {
+  if(n < Neq) n = Neq;
+  if(n == Nsys) return;
+  double* y = new double[n]();
+  for(int i = 0; i < Neq; ++i) y[i] = Y[i];
+  delete [] Y;
+  delete [] Ydot;
+  Y = y;
+  Ydot = new double[n]();
+  Nsys = n;
+  this->make_solver();
+}
+
+//! Create a solver of the current type for <code>Nsys</code> equations.
+void odepack_dlsoda::make_solver() {
+  delete Solver;
+  switch(Solver_type) {
+  case MRGSOLVE_SOLVER_RK45:
+    Solver = new rk45(Nsys);
+    break;
+  case MRGSOLVE_SOLVER_ROSENBROCK:
+    Solver = new rosenbrock(Nsys);
+    break;
+  case MRGSOLVE_SOLVER_EXPM:
+    Solver = new linear(Nsys);
+    break;
+  default:
+    Solver = new dlsoda(Nsys);
+  }
+  xistate = 1;
+}
 
+/**
+ * Advance the system from <code>tfrom</code> to <code>tto</code> with 
+ * the current solver.  The state vector, <code>istate</code> and the 
+ * optional outputs in <code>rwork</code> and <code>iwork</code> are 
+ * updated, and the steps, derivative evaluations and Jacobian evaluations 
+ * taken by the call are added to the run totals.
+ * 
+ * @param tfrom the starting time; set to the ending time on return
+ * @param tto the ending time
+ */
+void odepack_dlsoda::integrate(double& tfrom, const double& tto) {
+  if(xistate==1) {
+    xiwork[10] = 0;
+    xiwork[11] = 0;
+    xiwork[12] = 0;
+  }
+  const int nst = xiwork[10];
+  const int nfe = xiwork[11];
+  const int nje = xiwork[12];
+  Solver->run(this, Y, tfrom, tto, xrtol, xatol, xitask, xistate, 
+              xiopt, xrwork, xiwork, xjt);
+  Nstep += xiwork[10] - nst;
+  Nrhs += xiwork[11] - nfe;
+  Njac += xiwork[12] - nje;
+}
@@ -22,7 +22,10 @@
  */
 
 #include <cmath>
+#include <cfloat>
+#include <algorithm>
 #include <vector>
+#include <sstream>
 #include "RcppInclude.h"
 #include "odeproblem.h"
 #include "mrgsolve.h"
@@ -30,11 +33,27 @@
 static Rcpp::NumericMatrix OMEGADEF(1,1);
 static arma::mat OMGADEF(1,1,arma::fill::zeros);
 
-//! the maximum number of iterations for steady-state calculation
+//! the default maximum number of dosing intervals for steady state
 #define MRGSOLVE_MAX_SS_ITER 1000
 
+//! the maximum number of saved steady state results per thread
+#define MRGSOLVE_SS_CACHE_MAX 10000
+
+//! <code>simeta()</code> and <code>simeps()</code> for the <code>dual</code> 
+//! copies of the model functions; the draws from the last call are kept.
+static void nosimeta(void*) {}
+
 void dosimeta(void* prob_) {
   odeproblem* prob = reinterpret_cast<odeproblem*>(prob_);
+  if(prob->streaming()) {
+    prob->stream_simeta();
+    return;
+  }
+  if(prob->threaded()) {
+    throw mrgsolve_error(
+        "simeta() cannot be called when nthreads > 1 unless stream_seed is set."
+    );
+  }
   arma::mat eta = prob->mv_omega(1);
   for(unsigned int i=0; i < eta.n_cols; ++i) {
     prob->eta(i,eta(0,i)); 
@@ -43,10 +62,11 @@ void dosimeta(void* prob_) {
 
 void dosimeps(void* prob_) {
   odeproblem* prob = reinterpret_cast<odeproblem*>(prob_);
-  arma::mat eps = prob->mv_sigma(1);
-  for(unsigned int i=0; i < eps.n_cols; ++i) {
-    prob->eps(i,eps(0,i)); 
+  if(prob->streaming_eps()) {
+    prob->stream_simeps();
+    return;
   }
+  prob->r_simeps();
 }
 
 odeproblem::odeproblem(Rcpp::NumericVector param,
@@ -57,6 +77,7 @@ odeproblem::odeproblem(Rcpp::NumericVector param,
   int npar_ = int(param.size());
   int neq_ = int(init.size());
   Advan = 13;
+  Pk_next = 0;
   
   Param = new double[npar_]();
   Init_value.assign(neq_,0.0);
@@ -71,6 +92,22 @@ odeproblem::odeproblem(Rcpp::NumericVector param,
   
   On.assign(neq_,1);
   
+  Tstop = 0.0;
+  Use_tstop = false;
+  Warm_t = 0.0;
+  Warm_y.assign(neq_,0.0);
+  Warm_dxdt.assign(neq_,0.0);
+  Warm_param.assign(npar_,0.0);
+  
+  Nroot = 0;
+  Use_roots = false;
+  Root_found = 0;
+  Root_time = 0.0;
+  
+  Nsens = 0;
+  Nvars = 0;
+  Nsensw = 0;
+  
   d.evid = 0;
   d.newind = 0;
   d.time = 0.0;
@@ -80,10 +117,26 @@ odeproblem::odeproblem(Rcpp::NumericVector param,
   d.CFONSTOP = false;
   d.cmt = 0;
   d.amt = 0;
+  d.root = 0;
   
   Do_Init_Calc = true;
+  Threaded = false;
+  Streaming = false;
+  Stream_eps = false;
+  Eps_row = -1;
+  Resim_eta = 0;
+  Resim_eps = 0;
   
-  pred.assign(5,0.0);
+  Ss_n = MRGSOLVE_MAX_SS_ITER;
+  Ss_rtol = 1E-6;
+  Ss_atol = 1E-8;
+  Ss_report = false;
+  Ss_fail = 0;
+  Ss_cache = true;
+  Ss_hits = 0;
+  Ss_misses = 0;
+  
+  pred.assign(7,0.0);
   
   for(int i=0; i < npar_; ++i) Param[i] =       double(param[i]);
   for(int i=0; i < neq_;  ++i) Init_value[i] =  double(init[i]);
@@ -92,11 +145,16 @@ odeproblem::odeproblem(Rcpp::NumericVector param,
   *reinterpret_cast<void**>(&Table)  = R_ExternalPtrAddr(funs["table"]);
   *reinterpret_cast<void**>(&Derivs) = R_ExternalPtrAddr(funs["ode"]);
   *reinterpret_cast<void**>(&Config) = R_ExternalPtrAddr(funs["config"]);
+  this->copy_jac(funs);
+  this->copy_root(funs);
+  this->copy_vars(funs);
+  this->copy_sens_funs(funs);
   
   Capture.assign(n_capture_,0.0);
   
   simeta = mrgsolve::resim(&dosimeta,reinterpret_cast<void*>(this));
   simeps = mrgsolve::resim(&dosimeps,reinterpret_cast<void*>(this));
+  Sens_simeta = mrgsolve::resim(&nosimeta,reinterpret_cast<void*>(this));
   
 }
 
@@ -148,7 +206,7 @@ void odeproblem::y_init(int pos, double value) {
 }
 
 void odeproblem::y_init(Rcpp::NumericVector x) {
-  if(x.size() != Neq) Rcpp::stop("Initial vector is wrong size");
+  if(x.size() != Neq) throw mrgsolve_error("Initial vector is wrong size");
   for(int i = 0; i < x.size(); ++i) {
     Y[i] = x[i];
     Init_value[i] = x[i];
@@ -156,29 +214,212 @@ void odeproblem::y_init(Rcpp::NumericVector x) {
   }
 }
 
+void odeproblem::y_init(const dvec& x) {
+  if(x.size() != size_t(Neq)) throw mrgsolve_error("Initial vector is wrong size");
+  for(size_t i = 0; i < x.size(); ++i) {
+    Y[i] = x[i];
+    Init_value[i] = x[i];
+    Init_dummy[i] = x[i];
+  }
+}
+
 //! add <code>value</code> to compartment <code>pos</code>
 void odeproblem::y_add(const unsigned int pos, const double& value) {
   Y[pos] = Y[pos] + value; 
 }
 
 
-/** Derivative function that gets called by the solver. 
+/**
+ * Call <code>$ODE</code> and add the infusion rates.  When the solver 
+ * integrates sensitivities too (<code>neq</code> is more than 
+ * <code>Neq</code>), the <code>dual</code> copy of <code>$ODE</code> is 
+ * called once for each parameter, with the amounts carrying their 
+ * sensitivities and the parameters, the doubles from <code>$MAIN</code> 
+ * and the initial conditions carrying their derivatives; the derivative 
+ * it returns is the right hand side of the forward sensitivity equations, 
+ * the Jacobian times the sensitivities plus the derivative with respect to 
+ * the parameter.  Doses are fixed, so the infusion rates don't add to it.
  * 
- * @param neq number of equations
- * @param t solver time
- * @param y current state
- * @param ydot left hand side of differential equations
- * @param prob an odeproblem object
+ * @param neq the number of equations
+ * @param t the solver time
+ * @param y the state vector
+ * @param ydot the derivatives
  */
-void main_derivs(int *neq, double *t, double *y, double *ydot, odeproblem *prob) {
-  prob->call_derivs(neq,t,y,ydot);  
-}
-
 void odeproblem::call_derivs(int *neq, double *t, double *y, double *ydot) {
+  const bool sens = *neq > Neq;
+  if(sens && Nvars > 0) Vars(&Sens_v0[0], Nvars, false);
   Derivs(t,y,ydot,Init_value,Param);
   for(int i = 0; i < Neq; ++i) {
     ydot[i] = (ydot[i] + R0[i])*On[i]; 
   }
+  if(!sens) return;
+  for(int k = 0; k < Nsens; ++k) {
+    this->sens_point(k, y);
+    DerivsSens(t,&Sens_amt[0],&Sens_dadt[0],Sens_init,&Sens_theta[0],
+               &Sens_v[0],&Sens_w[0],Nsensw);
+    double* sdot = ydot + Neq*(k+1);
+    for(int i = 0; i < Neq; ++i) sdot[i] = Sens_dadt[i].d*On[i];
+  }
+}
+
+/**
+ * Set up the <code>dual</code> inputs for the copies of the model 
+ * functions, differentiating with respect to sensitivity parameter 
+ * <code>k</code>: the parameters, the amounts in <code>y</code> with 
+ * their sensitivities, the initial conditions and the doubles from 
+ * <code>$MAIN</code> as they were going into the last call 
+ * (<code>Sens_v0</code>), each with its derivative.
+ * 
+ * @param k the sensitivity parameter
+ * @param y the state vector
+ */
+void odeproblem::sens_point(const int k, const double* y) {
+  const int p = Sens_par[k];
+  for(int j = 0; j < Npar; ++j) {
+    Sens_theta[j] = dual(Param[j], j==p ? 1.0 : 0.0);
+  }
+  const double* s = y + Neq*(k+1);
+  const double* di = &Sens_dinit[0] + Neq*k;
+  for(int i = 0; i < Neq; ++i) {
+    Sens_amt[i] = dual(y[i], s[i]);
+    Sens_init[i] = dual(Init_value[i], di[i]);
+  }
+  const double* dv = &Sens_dvars[Nvars*k];
+  for(int i = 0; i < Nvars; ++i) Sens_v[i] = dual(Sens_v0[i], dv[i]);
+}
+
+/**
+ * Fill the Jacobian from the <code>$JAC</code> function.  Infusion rates 
+ * are constant over the call, so they don't contribute; rows for 
+ * compartments that are off are zero, like their derivatives.
+ * 
+ * With sensitivities, the solver always asks for the Jacobian here, so 
+ * that it only takes <code>Neq</code> columns by differences when there 
+ * is no <code>$JAC</code> function (see <code>jac_diff</code>).  The 
+ * Jacobian of the state variables goes down the diagonal once for the 
+ * amounts and once for each parameter; the terms that couple the 
+ * sensitivities to the state are left out, which only slows down the 
+ * corrector iteration.
+ * 
+ * @param neq the number of equations
+ * @param t the solver time
+ * @param y the state vector
+ * @param pd the Jacobian, <code>neq</code> by <code>neq</code> in 
+ * column-major order; comes in zeroed
+ */
+void odeproblem::call_jac(int *neq, double *t, double *y, double *pd) {
+  if(*neq > Neq) {
+    std::fill(Sens_jac.begin(), Sens_jac.end(), 0.0);
+    this->call_jac(&Neq, t, y, &Sens_jac[0]);
+    const int n = *neq;
+    for(int b = 0; b <= Nsens; ++b) {
+      for(int j = 0; j < Neq; ++j) {
+        for(int i = 0; i < Neq; ++i) {
+          pd[(b*Neq + i) + (b*Neq + j)*n] = Sens_jac[i + j*Neq];
+        }
+      }
+    }
+    return;
+  }
+  if(Jac==NULL) {
+    this->jac_diff(t, y, pd);
+    return;
+  }
+  Jac(t,y,pd,Init_value,Param);
+  for(int j = 0; j < Neq; ++j) {
+    for(int i = 0; i < Neq; ++i) {
+      pd[i + j*Neq] *= On[i];
+    }
+  }
+}
+
+/**
+ * The Jacobian of the state variables by forward differences of 
+ * <code>$ODE</code>, for models without a <code>$JAC</code> function; 
+ * <code>Neq + 1</code> calls.  The steps are like the ones 
+ * <code>DLSODA</code> takes.
+ * 
+ * @param t the solver time
+ * @param y the amounts
+ * @param pd the Jacobian, <code>Neq</code> by <code>Neq</code> in 
+ * column-major order
+ */
+void odeproblem::jac_diff(double* t, double* y, double* pd) {
+  const double srur = std::sqrt(DBL_EPSILON);
+  const double floor = xrtol > 0.0 ? xatol/xrtol : 1.0;
+  Derivs(t,y,&Sens_f0[0],Init_value,Param);
+  for(int i = 0; i < Neq; ++i) Sens_y[i] = y[i];
+  for(int j = 0; j < Neq; ++j) {
+    double del = srur*std::max(std::fabs(y[j]), floor);
+    if(del == 0.0) del = srur;
+    Sens_y[j] = y[j] + del;
+    del = Sens_y[j] - y[j];
+    double* col = pd + j*Neq;
+    Derivs(t,&Sens_y[0],col,Init_value,Param);
+    for(int i = 0; i < Neq; ++i) {
+      col[i] = (col[i] - Sens_f0[i])*On[i]/del;
+    }
+    Sens_y[j] = y[j];
+  }
+}
+
+/**
+ * Get the <code>$JAC</code> function, if the model has one, and pick the 
+ * Jacobian type for <code>DLSODA</code> to match.  For models built 
+ * without a <code>$JAC</code> block (or by older versions), the pointer 
+ * is <code>NULL</code>; the Jacobian comes from <code>call_jac</code> 
+ * anyway when there are sensitivities.
+ * 
+ * @param funs list of pointer addresses to model functions
+ */
+void odeproblem::copy_jac(const Rcpp::List& funs) {
+  *reinterpret_cast<void**>(&Jac) = R_ExternalPtrAddr(funs["jac"]);
+  xjt = (Jac==NULL && Nsens==0) ? 2 : 1;
+}
+
+/**
+ * Get the <code>$ROOT</code> function, if the model has one.  For models 
+ * built without a <code>$ROOT</code> block (or by older versions), the 
+ * pointer is <code>NULL</code> and no roots are watched.
+ * 
+ * @param funs list of pointer addresses to model functions
+ */
+void odeproblem::copy_root(const Rcpp::List& funs) {
+  *reinterpret_cast<void**>(&Root) = R_ExternalPtrAddr(funs["root"]);
+}
+
+/**
+ * Get the function that gets and sets the doubles from 
+ * <code>$MAIN</code>, and how many there are.  Models built by older 
+ * versions don't have one; the pointer is <code>NULL</code>.
+ * 
+ * @param funs list of pointer addresses to model functions
+ */
+void odeproblem::copy_vars(const Rcpp::List& funs) {
+  *reinterpret_cast<void**>(&Vars) = R_ExternalPtrAddr(funs["vars"]);
+  Nvars = 0;
+  if(Vars != NULL) Vars(NULL, Nvars, false);
+  Warm_vars.assign(Nvars > 0 ? Nvars : 1, 0.0);
+  Warm_v.assign(Nvars > 0 ? Nvars : 1, 0.0);
+}
+
+/**
+ * Get the <code>dual</code> copies of <code>$MAIN</code>, 
+ * <code>$ODE</code> and <code>$TABLE</code>, and how many doubles 
+ * <code>$ODE</code> declares.  Only models built with 
+ * <code>$PLUGIN sens</code> have them; otherwise the pointers are 
+ * <code>NULL</code>.
+ * 
+ * @param funs list of pointer addresses to model functions
+ */
+void odeproblem::copy_sens_funs(const Rcpp::List& funs) {
+  *reinterpret_cast<void**>(&InitsSens) = R_ExternalPtrAddr(funs["main_sens"]);
+  *reinterpret_cast<void**>(&DerivsSens) = R_ExternalPtrAddr(funs["ode_sens"]);
+  *reinterpret_cast<void**>(&TableSens) = R_ExternalPtrAddr(funs["table_sens"]);
+  Nsensw = 0;
+  if(DerivsSens != NULL) {
+    DerivsSens(NULL,NULL,NULL,Sens_init,NULL,NULL,NULL,Nsensw);
+  }
 }
 
 
@@ -187,6 +428,7 @@ void odeproblem::set_d(rec_ptr this_rec) {
   d.cmt = this_rec->cmt();
   d.evid = this_rec->evid();
   d.amt = this_rec->amt();
+  d.root = 0;
 }
 
 /**
@@ -198,17 +440,26 @@ void odeproblem::init_call(const double& time) {
   
   d.time = time;
   
+  for(int i = Neq; i < Nsys; ++i) Y[i] = 0.0;
+  
   if(Do_Init_Calc) {
-    Inits(Init_value,Y,Param,F,Alag,R,D,d,pred,simeta);
+    this->main_call(Init_value);
     for(int i=0; i < Neq; ++i) {
       Y[i] = Init_value[i];
       Init_dummy[i] = Init_value[i];
     }
+    // The sensitivities start from the derivatives of the initial 
+    // conditions set in $MAIN
+    Sens_dinit = Sens_da0;
+    for(int k = 0; k < Nsens; ++k) {
+      for(int i = 0; i < Neq; ++i) Y[Neq*(k+1) + i] = Sens_da0[Neq*k + i];
+    }
   } else {
     for(int i=0; i < Neq; ++i) {
       Init_dummy[i] = Init_value[i];
     }
-    Inits(Init_dummy,Y,Param,F,Alag,R,D,d,pred,simeta);
+    this->main_call(Init_dummy);
+    std::fill(Sens_dinit.begin(), Sens_dinit.end(), 0.0);
   }
 }
 
@@ -220,7 +471,62 @@ void odeproblem::init_call(const double& time) {
  */
 void odeproblem::init_call_record(const double& time) {
   d.time = time;
-  Inits(Init_dummy,Y,Param,F,Alag,R,D,d,pred,simeta);
+  this->main_call(Init_dummy);
+}
+
+/**
+ * Call <code>$MAIN</code>.  With sensitivities, the initial conditions, 
+ * <code>pred</code> and the doubles from <code>$MAIN</code> going into 
+ * the call are saved for <code>main_sens</code>.
+ * 
+ * @param init the initial conditions passed to <code>$MAIN</code>
+ */
+void odeproblem::main_call(dvec& init) {
+  if(Nsens > 0) {
+    Sens_i0 = init;
+    Sens_p0 = pred;
+    if(Nvars > 0) Vars(&Sens_v0[0], Nvars, false);
+  }
+  Inits(init,Y,Param,F,Alag,R,D,d,pred,simeta);
+  if(Nsens > 0) this->main_sens();
+}
+
+/**
+ * Differentiate the last <code>$MAIN</code> call with respect to each 
+ * sensitivity parameter: the <code>dual</code> copy of <code>$MAIN</code> 
+ * is called with the same inputs, so that the doubles it declares, 
+ * <code>pred</code> and the initial conditions come back with their 
+ * derivatives.  Those are kept for <code>$ODE</code>, <code>$TABLE</code>, 
+ * <code>advan_sens</code> and <code>init_call</code>.  The doubles start 
+ * from their values and derivatives before the call, so ones that are 
+ * only set on some records keep their derivatives too.
+ * 
+ * The copy gets the <code>ETA</code> the call left in <code>self</code> 
+ * and can't draw new ones.  Doses are fixed: what it does to 
+ * <code>F</code>, <code>ALAG</code>, <code>R</code> and <code>D</code>, 
+ * and to <code>self</code>, is dropped.
+ */
+void odeproblem::main_sens() {
+  const int np = pred.size();
+  for(int k = 0; k < Nsens; ++k) {
+    this->sens_point(k, Y);
+    for(int i = 0; i < Neq; ++i) {
+      Sens_a0[i] = Sens_i0[i];
+      Sens_F[i] = F[i];
+      Sens_alag[i] = Alag[i];
+      Sens_R[i] = R[i];
+      Sens_D[i] = D[i];
+    }
+    double* dp = &Sens_dpred[np*k];
+    for(int j = 0; j < np; ++j) Sens_pred[j] = dual(Sens_p0[j], dp[j]);
+    Sens_self = d;
+    InitsSens(Sens_a0,&Sens_amt[0],&Sens_theta[0],Sens_F,Sens_alag,Sens_R,
+              Sens_D,Sens_self,Sens_pred,Sens_simeta,&Sens_v[0]);
+    double* dv = &Sens_dvars[Nvars*k];
+    for(int i = 0; i < Nvars; ++i) dv[i] = Sens_v[i].d;
+    for(int j = 0; j < np; ++j) dp[j] = Sens_pred[j].d;
+    for(int i = 0; i < Neq; ++i) Sens_da0[Neq*k + i] = Sens_a0[i].d;
+  }
 }
 
 //! Call <code>$TABLE</code> function.
@@ -228,6 +534,41 @@ void odeproblem::table_call() {
   Table(Y,Init_value,Param,F,R,d,pred,Capture,simeps);  
 }
 
+/**
+ * Call <code>$TABLE</code> and get the sensitivities of the captured 
+ * items from its <code>dual</code> copy, called once for each sensitivity 
+ * parameter after the real call.  The doubles from <code>$ODE</code> come 
+ * from a call to the copy of <code>$ODE</code> at the current amounts.  
+ * The copies get the <code>EPS</code> (and <code>simeps()</code> draws) 
+ * the real call ended with, and anything they do to <code>self</code> is 
+ * dropped.
+ */
+void odeproblem::table_call_sens() {
+  if(Nvars > 0) Vars(&Sens_v0[0], Nvars, false);
+  this->table_call();
+  const size_t nc = Capture.size();
+  const int np = pred.size();
+  double t = d.time;
+  for(int k = 0; k < Nsens; ++k) {
+    this->sens_point(k, Y);
+    if(Nsensw > 0) {
+      DerivsSens(&t,&Sens_amt[0],&Sens_dadt[0],Sens_init,&Sens_theta[0],
+                 &Sens_v[0],&Sens_w[0],Nsensw);
+    }
+    for(int i = 0; i < Neq; ++i) {
+      Sens_F[i] = F[i];
+      Sens_R[i] = R[i];
+    }
+    const double* dp = &Sens_dpred[np*k];
+    for(int j = 0; j < np; ++j) Sens_pred[j] = dual(pred[j], dp[j]);
+    Sens_self = d;
+    TableSens(&Sens_amt[0],Sens_init,&Sens_theta[0],Sens_F,Sens_R,Sens_self,
+              Sens_pred,Sens_cap,Sens_simeta,&Sens_v[0],&Sens_w[0]);
+    double* sc = &Sens_capture[k*nc];
+    for(size_t c = 0; c < nc; ++c) sc[c] = Sens_cap[c].d;
+  }
+}
+
 //! Call <code>$PREAMBLE</code> function.
 void odeproblem::config_call() {
   Config(d,Param,Neq,Npar);
@@ -244,13 +585,13 @@ void odeproblem::rate_reset() {
 void odeproblem::rate_main(rec_ptr rec) {
   if(rec->rate() == -1) {
     if(this->rate(rec->cmtn()) <= 0) {
-      throw Rcpp::exception("Invalid infusion setting: rate (R_CMT).", false);
+      throw mrgsolve_error("Invalid infusion setting: rate (R_CMT).");
     }
     rec->rate(this->rate(rec->cmtn()));
   }
   if(rec->rate() == -2) {
     if(this->dur(rec->cmtn()) <= 0) {
-      throw Rcpp::exception("Invalid infusion setting: duration (D_CMT).",false);
+      throw mrgsolve_error("Invalid infusion setting: duration (D_CMT).");
     }
     rec->rate(rec->amt() * this->fbio(rec->cmtn()) / this->dur(rec->cmtn()));
   }
@@ -275,6 +616,92 @@ void odeproblem::reset_newid(const double id_) {
   d.SYSTEMOFF=0;
   this->lsoda_init();
   d.id = id_;
+  Resim_eta = 0;
+  Resim_eps = 0;
+}
+
+/**
+ * Clear the outcomes that are reported for a simulation run (the steady 
+ * state log and counts and the solver counts) so the object can be used 
+ * for another run.  Saved steady state results are kept; they are keyed 
+ * on the parameters.
+ */
+void odeproblem::reset_run() {
+  Ss_log.clear();
+  Ss_fail = 0;
+  Ss_hits = 0;
+  Ss_misses = 0;
+  Nstep = 0;
+  Nrhs = 0;
+  Njac = 0;
+}
+
+/**
+ * Save the state of the current subject, including the doubles from 
+ * <code>$MAIN</code> (which keep their values from one record to the 
+ * next).
+ * 
+ * @param state where the state goes
+ */
+void odeproblem::save(odestate& state) const {
+  state.y.assign(Y, Y + Nsys);
+  state.param.assign(Param, Param + Npar);
+  state.r0 = R0;
+  state.infusion_count = infusion_count;
+  state.r = R;
+  state.dur = D;
+  state.f = F;
+  state.alag = Alag;
+  state.on = On;
+  state.init = Init_value;
+  state.pred = pred;
+  int nvars = Nvars;
+  state.vars.assign(nvars, 0.0);
+  if(nvars > 0) Vars(&state.vars[0], nvars, false);
+  state.dsens = Sens_dinit;
+  state.dsens.insert(state.dsens.end(), Sens_dpred.begin(), Sens_dpred.end());
+  state.dsens.insert(state.dsens.end(), Sens_dvars.begin(), Sens_dvars.end());
+  state.d = d;
+  state.resim_eta = Resim_eta;
+  state.resim_eps = Resim_eps;
+}
+
+/**
+ * Pick up a subject from a saved state.  The solver is started again at
+ * the next advance.
+ * 
+ * @param state the state from <code>save</code>
+ */
+void odeproblem::restore(const odestate& state) {
+  std::copy(state.y.begin(), state.y.end(), Y);
+  std::copy(state.param.begin(), state.param.end(), Param);
+  R0 = state.r0;
+  infusion_count = state.infusion_count;
+  R = state.r;
+  D = state.dur;
+  F = state.f;
+  Alag = state.alag;
+  On = state.on;
+  Init_value = state.init;
+  pred = state.pred;
+  int nvars = Nvars;
+  if(nvars > 0 && int(state.vars.size())==nvars) {
+    dvec vars(state.vars);
+    Vars(&vars[0], nvars, true);
+  }
+  if(state.dsens.size()==Sens_dinit.size() + Sens_dpred.size() + 
+     Sens_dvars.size()) {
+    dvec::const_iterator it = state.dsens.begin();
+    std::copy(it, it + Sens_dinit.size(), Sens_dinit.begin());
+    it += Sens_dinit.size();
+    std::copy(it, it + Sens_dpred.size(), Sens_dpred.begin());
+    it += Sens_dpred.size();
+    std::copy(it, state.dsens.end(), Sens_dvars.begin());
+  }
+  d = state.d;
+  Resim_eta = state.resim_eta;
+  Resim_eps = state.resim_eps;
+  this->lsoda_init();
 }
 
 void odeproblem::rate_add(const unsigned int pos, const double& value) {
@@ -304,37 +731,28 @@ void odeproblem::on(const unsigned short int eq_n) {
 
 void odeproblem::off(const unsigned short int eq_n) {
   if(infusion_count[eq_n]>0) {
-    Rcpp::stop("Attempting to turn compartment off when infusion is on.");
+    throw mrgsolve_error("Attempting to turn compartment off when infusion is on.");
   }
   On[eq_n] = 0;
   this->y(eq_n,0.0);
+  this->sens_clear(eq_n);
 }
 
-extern "C" {
-  void F77_NAME(dlsoda) (
-      main_deriv_func *derivs,
-      int             *neq,
-      double          *y,
-      const double    *tfrom,
-      const double    *tto,
-      int             *itol,
-      double          *rtol,
-      double          *atol,
-      int             *itask,
-      int             *istate,
-      int             *iopt,
-      double          *rwork,
-      int             *lrwork,
-      int             *iwork,
-      int             *liwork,
-      int             *dum, // dummy jacobian
-      int             *jt, // jacobian type
-      odeproblem      *prob
-  );
+//! Zero the sensitivities for compartment <code>pos</code>.
+void odeproblem::sens_clear(const int pos) {
+  for(int k = 0; k < Nsens; ++k) Y[Neq*(k+1) + pos] = 0.0;
 }
 
 void odeproblem::advance(double tfrom, double tto) {
   
+  const bool stop = Use_tstop;
+  const double tstop = Tstop;
+  Use_tstop = false;
+  
+  const bool roots = Use_roots && (Nroot > 0) && (Root != NULL);
+  Use_roots = false;
+  Root_found = 0;
+  
   if(Neq == 0) return;
   
   if(Advan != 13) {
@@ -347,225 +765,291 @@ void odeproblem::advance(double tfrom, double tto) {
       this->advan4(tfrom,tto);
       return;
     }
-    // If Advan isn't 13, it needs to be 0/1/2/3/4
-    Rcpp::stop("mrgsolve: advan has invalid value.");
+    
+    if((Advan==12) | (Advan==11)) {
+      this->advan12(tfrom,tto);
+      return;
+    }
+    // If Advan isn't 13, it needs to be 0/1/2/3/4/11/12
+    throw mrgsolve_error("mrgsolve: advan has invalid value.");
   }
  
-  F77_CALL(dlsoda)(
-      &main_derivs,
-      &Neq,
-      Y,
-      &tfrom,
-      &tto,
-      &xitol,
-      &xrtol,
-      &xatol,
-      &xitask,
-      &xistate,
-      &xiopt,
-      xrwork,
-      &xlrwork,
-      xiwork,
-      &xliwork,
-      &Neq,
-      &xjt,
-      this
-  );
-  
-  this->call_derivs(&Neq, &tto, Y, Ydot);
-}
-
-void odeproblem::advan2(const double& tfrom, const double& tto) {
-  
-  unsigned int neq = this->neq();
+  this->warm_check(tfrom);
   
-  double dt = tto-tfrom;
-  
-  if(MRGSOLVE_GET_PRED_CL <= 0) Rcpp::stop("pred_CL has a 0 or negative value.");
-  if(MRGSOLVE_GET_PRED_VC <= 0) Rcpp::stop("pred_VC has a 0 or negative value.");
-  
-  double k10 = MRGSOLVE_GET_PRED_K10;
-  double ka =  MRGSOLVE_GET_PRED_KA;
-  
-  if(k10 <= 0) Rcpp::stop("k10 has a 0 or negative value");
+  // With dense output (a stop time was set), let the solver take its own 
+  // steps up to the next discontinuity and interpolate back to tto; it 
+  // can't stop there if it has already stepped past it
+  xitask = 1;
+  if(stop && (tstop >= tto) && ((xistate==1) || (tstop >= xrwork[12]))) {
+    xitask = 4;
+    xrwork[0] = tstop;
+  }
   
-  //a and alpha are private members
-  alpha[0] = k10;
-  alpha[1] = ka;
+  double tend = tto;
+  if(roots) {
+    this->integrate_roots(tfrom, tend);
+  } else {
+    this->integrate(tfrom,tto);
+    this->solver_check();
+  }
   
-  a[0] = ka/(ka-alpha[0]);
-  a[1] = -a[0];
+  if(Nvars > 0) Vars(&Warm_vars[0], Nvars, false);
+  this->call_derivs(&Nsys, &tend, Y, Ydot);
   
-  double init0 = 0, init1 = 0;
-  int eqoffset = 0;
+  Warm_t = tend;
+  for(int i = 0; i < Nsys; ++i) Warm_y[i] = Y[i];
+  for(int i = 0; i < Npar; ++i) Warm_param[i] = Param[i];
+}
+
+/**
+ * Deal with the outcome of the last solver call: stop if the solver was 
+ * called after it failed and pass along any messages it left.  On a 
+ * worker thread, where we can't write to the console, a failure is an 
+ * error.
+ */
+void odeproblem::solver_check() {
   
-  if(neq==1) {
-    init0 = 0;
-    init1 = this->y(0);
-    eqoffset = 1;
-  }
-  if(neq==2) {
-    init0 = this->y(0);
-    init1 = this->y(1);
+  if(Solver->aborted) {
+    throw mrgsolve_error("ODE solver run aborted; istate was negative on entry.");
   }
   
-  double pred0 = 0, pred1 = 0;
-  
-  if(neq ==2) {
-    if((init0!=0) || (R0[0]!=0)) {
-      
-      pred0 = init0*exp(-ka*dt);//+ R0[0]*(1-exp(-ka*dt))/ka;
-      
-      if(ka > 0) { // new
-        pred0 += R0[0]*(1.0-exp(-ka*dt))/ka; // new
-        pred1 +=
-          PolyExp(dt,init0,0.0  ,0.0,0.0,false,a,alpha,2) +
-          PolyExp(dt,0.0  ,R0[0],dt ,0.0,false,a,alpha,2);
-      } else {
-        pred0 += R0[0]*dt; // new
+  if(!Solver->messages.empty()) {
+    if(Threaded) {
+      // Can't write to the console from a worker thread
+      if(xistate < 0) {
+        std::ostringstream ss;
+        for(size_t i = 0; i < Solver->messages.size(); ++i) {
+          ss << Solver->messages[i] << std::endl;
+        }
+        ss << "ODE solver returned with istate " << xistate;
+        throw mrgsolve_error(ss.str());
+      }
+    } else {
+      for(size_t i = 0; i < Solver->messages.size(); ++i) {
+        Rcpp::Rcout << Solver->messages[i] << std::endl;
       }
     }
   }
-  
-  if((init1!=0) || (R0[1-eqoffset]!=0)) {
-    a[0] = 1;
-    pred1 +=
-      PolyExp(dt,init1,0.0  ,0.0,0.0,false,a,alpha,1) +
-      PolyExp(dt,0.0  ,R0[1-eqoffset],dt ,0.0,false,a,alpha,1);
-  }
-  
-  if(neq==2) {
-    this->y(0,pred0);
-    this->y(1,pred1);
-  }
-  if(neq==1) {
-    this->y(0,pred1);
-  }
 }
 
-
-void odeproblem::advan4(const double& tfrom, const double& tto) {
-  
-  double dt = tto - tfrom;
-  
-  unsigned int neq = this->neq();
-  
-  // Make sure parameters are valid
-  if (MRGSOLVE_GET_PRED_VC <=  0) Rcpp::stop("pred_VC has a 0 or negative  value.");
-  if (MRGSOLVE_GET_PRED_VP <=  0) Rcpp::stop("pred_VP has a 0 or negative  value.");
-  if (MRGSOLVE_GET_PRED_Q  <   0) Rcpp::stop("pred_Q has a  negative  value.");
-  if (MRGSOLVE_GET_PRED_CL <=  0) Rcpp::stop("pred_CL has a 0 or negative  value.");
-  
-  double ka =  MRGSOLVE_GET_PRED_KA;
-  double k10 = MRGSOLVE_GET_PRED_K10;
-  double k12 = MRGSOLVE_GET_PRED_K12;
-  double k21 = MRGSOLVE_GET_PRED_K21;
-  
-  double ksum = k10+k12+k21;
-  
-  double init0 = 0, init1 = 0, init2 = 0,  pred0 = 0, pred1 = 0, pred2 = 0;
-  
-  int eqoffset = 0;
+/**
+ * Integrate up to <code>tend</code> one solver step at a time, watching 
+ * the <code>$ROOT</code> functions for a change of sign.  When one 
+ * changes sign, the crossing is located inside the step from the 
+ * solver's interpolant and the call ends there: the amounts are the ones 
+ * at the crossing, <code>tend</code> is set to the crossing time, 
+ * <code>root_found()</code> returns the root that crossed and the solver 
+ * starts over on the next call.  Otherwise, the amounts are the ones at 
+ * <code>tend</code>.
+ * 
+ * A root function that is zero at <code>tfrom</code> takes its sign from 
+ * the first nonzero value, so a crossing that was just handled (or that 
+ * a dose at <code>tfrom</code> put exactly on zero) isn't reported again.
+ * 
+ * @param tfrom the starting time
+ * @param tend the ending time; set to the crossing time on return if a 
+ * root was found
+ */
+void odeproblem::integrate_roots(const double tfrom, double& tend) {
+  const double tto = tend;
+  const int task = xitask;
   
-  if(neq == 2) {
-    init0 = 0; init1 = this->y(0); init2 = this->y(1);
-    eqoffset = 1;
-  }
-  if(neq ==3) {
-    init0 = this->y(0); init1 = this->y(1); init2 = this->y(2);
+  double tlo = tfrom;
+  this->root_call(tlo, Y, &Root_lo[0]);
+  for(int k = 0; k < Nroot; ++k) {
+    Root_sign[k] = (Root_lo[k] > 0.0) - (Root_lo[k] < 0.0);
   }
   
-  //a and alpha are private members
-  
-  alpha[0] = (ksum + sqrt(ksum*ksum-4.0*k10*k21))/2.0;
-  alpha[1] = (ksum - sqrt(ksum*ksum-4.0*k10*k21))/2.0;
-  alpha[2] = ka;
+  // A warm solver may already have stepped past tfrom
+  double th = xistate==2 ? std::max(xrwork[12], tfrom) : tfrom;
+  double t = tfrom;
   
-  if(neq==3) { // only do the absorption compartment if we have 3
-    if((init0 != 0) || (R0[0] != 0)) {
-      
-      pred0 = init0*exp(-ka*dt);// + R0[0]*(1.0-exp(-ka*dt))/ka;
-      
-      a[0] = ka*(k21-alpha[0])/((ka-alpha[0])*(alpha[1]-alpha[0]));
-      a[1] = ka*(k21-alpha[1])/((ka-alpha[1])*(alpha[0]-alpha[1]));
-      a[2] = -(a[0]+a[1]);
-      
-      if(ka > 0) {  // new
-        pred0 += R0[0]*(1.0-exp(-ka*dt))/ka; // new
-        pred1 +=
-          PolyExp(dt,init0,0,0,0,false,a,alpha,3) +
-          PolyExp(dt,0,R0[0],dt,0,false,a,alpha,3);
-        
-        a[0] = ka * k12/((ka-alpha[0])*(alpha[1]-alpha[0]));
-        a[1] = ka * k12/((ka-alpha[1])*(alpha[0]-alpha[1]));
-        a[2] = -(a[0] + a[1]);
-        
-        pred2 +=
-          PolyExp(dt,init0,0,0,0,false,a,alpha,3) +
-          PolyExp(dt,0,R0[0],dt,0,false,a,alpha,3);
-      } else {
-        pred0 += R0[0]*dt; // new
+  for(;;) {
+    const double tc = std::min(th, tto);
+    if(tc > tlo) {
+      this->root_interp(tc, &Root_y[0]);
+      this->root_call(tc, &Root_y[0], &Root_hi[0]);
+      if(this->root_flip(Root_hi) > 0) {
+        const double tr = this->root_locate(tlo, tc);
+        this->root_interp(tr, Y);
+        Root_found = this->root_flip(Root_hi);
+        Root_time = tr;
+        tend = tr;
+        xistate = 1;
+        return;
+      }
+      for(int k = 0; k < Nroot; ++k) {
+        if(Root_sign[k]==0) {
+          Root_sign[k] = (Root_hi[k] > 0.0) - (Root_hi[k] < 0.0);
+        }
       }
+      Root_lo.swap(Root_hi);
+      tlo = tc;
     }
+    if(th >= tto) break;
+    xitask = task==4 ? 5 : 2;
+    this->integrate(t, tto);
+    this->solver_check();
+    if(xistate < 0) return;
+    th = t;
   }
   
-  if((init1 != 0) || (R0[1-eqoffset] != 0)) {
-    
-    a[0] = (k21 - alpha[0])/(alpha[1]-alpha[0]) ;
-    a[1] = (k21 - alpha[1])/(alpha[0]-alpha[1]) ;
-    
-    pred1 +=
-      PolyExp(dt,init1,0,0,0,false,a,alpha,2) +
-      PolyExp(dt,0,R0[1-eqoffset],dt,0,false,a,alpha,2);
-    
-    a[0] = k12/(alpha[1]-alpha[0]) ;
-    a[1] = -a[0];
-    
-    pred2 +=
-      PolyExp(dt,init1,0,0,0,false,a,alpha,2) +
-      PolyExp(dt,0,R0[1-eqoffset],dt,0,false,a,alpha,2);
-  }
-  
-  if((init2 != 0) || (R0[2-eqoffset] != 0)) {
-    
-    a[0] = k21/(alpha[1]-alpha[0]);
-    a[1] = -a[0];
-    
-    pred1 +=
-      PolyExp(dt,init2,0,0,0,false,a,alpha,2) +
-      PolyExp(dt,0,R0[2-eqoffset],dt,0,false,a,alpha,2);
-    
-    a[0] = (k10 + k12 - alpha[0])/(alpha[1]-alpha[0]);
-    a[1] = (k10 + k12 - alpha[1])/(alpha[0]-alpha[1]);
-    
-    pred2 +=
-      PolyExp(dt,init2,0,0,0,false,a,alpha,2) +
-      PolyExp(dt,0,R0[2-eqoffset],dt,0,false,a,alpha,2);
-  }
-  
-  if(neq ==2) {
-    this->y(0,pred1);
-    this->y(1,pred2);
-  }
-  if(neq ==3) {
-    this->y(0,pred0);
-    this->y(1,pred1);
-    this->y(2,pred2);
+  if(tto > tfrom) this->root_interp(tto, Y);
+}
+
+//! Call <code>$ROOT</code> at time <code>t</code> with amounts <code>y</code>.
+void odeproblem::root_call(double t, double* y, double* g) {
+  Root(&t, y, g, Init_value, Param);
+}
+
+/**
+ * Get the amounts at a time inside the solver's last step from its 
+ * interpolant; the solver itself doesn't move.
+ * 
+ * @param t the time
+ * @param y the amounts at <code>t</code>
+ */
+void odeproblem::root_interp(const double t, double* y) {
+  double tt = t;
+  int istate = 2;
+  Solver->run(this, y, tt, t, xrtol, xatol, 1, istate, xiopt, xrwork, 
+              xiwork, xjt);
+}
+
+/**
+ * Find the first root function that changed sign.
+ * 
+ * @param g the root functions at the end of the bracket
+ * @return the root (1-based) or 0 if none changed sign
+ */
+int odeproblem::root_flip(const dvec& g) const {
+  for(int k = 0; k < Nroot; ++k) {
+    if(Root_sign[k]==0) continue;
+    if(g[k]==0.0 || ((g[k] > 0.0) - (g[k] < 0.0)) != Root_sign[k]) {
+      return k+1;
+    }
   }
+  return 0;
 }
 
+/**
+ * Narrow the bracket around the earliest crossing with the Illinois 
+ * method (the secant guess is taken from the root that would cross 
+ * first).  <code>Root_lo</code> and <code>Root_hi</code> hold the root 
+ * functions at the ends of the bracket on entry and on return.
+ * 
+ * @param tlo start of the bracket; no root has crossed here
+ * @param thi end of the bracket; at least one root has crossed here
+ * @return the end of the final bracket, where the root has just crossed
+ */
+double odeproblem::root_locate(double tlo, double thi) {
+  const double tol = 100.0*DBL_EPSILON*(std::fabs(tlo) + std::fabs(thi));
+  double wlo = 1.0, whi = 1.0;
+  int last = 0;
+  for(int iter = 0; (iter < 100) && (thi - tlo > tol); ++iter) {
+    double frac = 1.0;
+    for(int k = 0; k < Nroot; ++k) {
+      if(Root_sign[k]==0) continue;
+      const double glo = wlo*Root_lo[k];
+      const double ghi = whi*Root_hi[k];
+      if(glo==ghi) continue;
+      const double f = glo/(glo - ghi);
+      if(f >= 0.0 && f < frac) frac = f;
+    }
+    double tm = tlo + frac*(thi - tlo);
+    tm = std::max(tm, tlo + 0.5*tol);
+    tm = std::min(tm, thi - 0.5*tol);
+    this->root_interp(tm, &Root_y[0]);
+    this->root_call(tm, &Root_y[0], &Root_mid[0]);
+    if(this->root_flip(Root_mid) > 0) {
+      thi = tm;
+      Root_hi.swap(Root_mid);
+      whi = 1.0;
+      if(last < 0) wlo *= 0.5;
+      last = -1;
+    } else {
+      tlo = tm;
+      Root_lo.swap(Root_mid);
+      wlo = 1.0;
+      if(last > 0) whi *= 0.5;
+      last = 1;
+    }
+  }
+  return thi;
+}
 
-double PolyExp(const double& x,
-               const double& dose,
-               const double& rate,
-               const double& xinf,
-               const double& tau,
-               const bool ss,
-               const dvec& a,
-               const dvec& alpha,
-               const int n) {
+/**
+ * Decide if <code>DLSODA</code> can continue from where the last call 
+ * left off (<code>istate = 2</code>).  The solver keeps its step size, 
+ * order, history and Jacobian unless something discontinuous happened 
+ * since then: we aren't starting at the time where the solver stopped, 
+ * the amounts or the parameters changed, <code>$MAIN</code> assigned a 
+ * different value to one of its doubles, or the derivatives of the full 
+ * system (amounts and sensitivities) at the current amounts changed 
+ * (infusion rates, compartments turned on or off).  Otherwise, the 
+ * solver is restarted.
+ * 
+ * @param tfrom the starting time for the next call
+ */
+void odeproblem::warm_check(const double tfrom) {
+  if(xistate != 2) {
+    xistate = 1;
+    return;
+  }
+  if(tfrom != Warm_t) {
+    xistate = 1;
+    return;
+  }
+  for(int i = 0; i < Nsys; ++i) {
+    if(Y[i] != Warm_y[i]) {
+      xistate = 1;
+      return;
+    }
+  }
+  for(int i = 0; i < Npar; ++i) {
+    if(Param[i] != Warm_param[i]) {
+      xistate = 1;
+      return;
+    }
+  }
+  if(Nvars > 0) {
+    Vars(&Warm_v[0], Nvars, false);
+    for(int i = 0; i < Nvars; ++i) {
+      if(Warm_v[i] != Warm_vars[i]) {
+        xistate = 1;
+        return;
+      }
+    }
+  }
+  double t = tfrom;
+  this->call_derivs(&Nsys, &t, Y, &Warm_dxdt[0]);
+  for(int i = 0; i < Nsys; ++i) {
+    if(Warm_dxdt[i] != Ydot[i]) {
+      xistate = 1;
+      return;
+    }
+  }
+}
+
+/**
+ * Calculate PK model polyexponentials.  Written for <code>double</code> 
+ * and for <code>dual</code>, which carries the derivative with respect to 
+ * one parameter along; <code>PolyExp</code> is the <code>double</code> 
+ * version.
+ */
+template<typename T>
+static T polyexp(const double& x,
+                 const T& dose,
+                 const T& rate,
+                 const double& xinf,
+                 const double& tau,
+                 const bool ss,
+                 const std::vector<T>& a,
+                 const std::vector<T>& alpha,
+                 const int n) {
   
-  double result=0, bolusResult, dx, nlntv ;
+  T result=0, bolusResult;
+  double dx, nlntv ;
   double inf=1E9;
   //maximum value for a double in C++
   int i;
@@ -611,7 +1095,7 @@ double PolyExp(const double& x,
     }
     
     else if(!ss) {
-      if(xinf <= tau) Rcpp::stop("xinf <= tau in PolyExp");
+      if(xinf <= tau) throw mrgsolve_error("xinf <= tau in PolyExp");
       //assert(xinf <= tau); //and other case later, says Bill
       dx=x-trunc(x/tau)*tau;
       nlntv=trunc(x/tau)+1;
@@ -633,7 +1117,7 @@ double PolyExp(const double& x,
     }
     
     else {
-      if(xinf <= tau) Rcpp::stop("xinf <= tau in PolyExp");
+      if(xinf <= tau) throw mrgsolve_error("xinf <= tau in PolyExp");
       dx = x - trunc(x/tau)*tau;
       nlntv = trunc(x/tau)+1;
       if (dx <= xinf) {
@@ -663,6 +1147,512 @@ double PolyExp(const double& x,
   return bolusResult + rate*result;
 }
 
+double PolyExp(const double& x,
+               const double& dose,
+               const double& rate,
+               const double& xinf,
+               const double& tau,
+               const bool ss,
+               const dvec& a,
+               const dvec& alpha,
+               const int n) {
+  return polyexp<double>(x,dose,rate,xinf,tau,ss,a,alpha,n);
+}
+
+/**
+ * Advance the one-compartment model (advan 1 and 2) by <code>dt</code>.
+ * 
+ * @param k10 elimination rate constant
+ * @param ka absorption rate constant
+ * @param neq the number of compartments; 2 with a depot
+ * @param dt the time step
+ * @param y the amounts; updated
+ * @param r0 the infusion rates
+ * @param a scratch space for coefficients
+ * @param alpha scratch space for exponents
+ */
+template<typename T>
+static void advan2_calc(const T& k10, const T& ka, const int neq,
+                        const double dt, T* y, const double* r0,
+                        std::vector<T>& a, std::vector<T>& alpha) {
+  
+  alpha[0] = k10;
+  alpha[1] = ka;
+  
+  a[0] = ka/(ka-alpha[0]);
+  a[1] = -a[0];
+  
+  T init0 = 0, init1 = 0;
+  int eqoffset = 0;
+  
+  if(neq==1) {
+    init0 = 0;
+    init1 = y[0];
+    eqoffset = 1;
+  }
+  if(neq==2) {
+    init0 = y[0];
+    init1 = y[1];
+  }
+  
+  T pred0 = 0, pred1 = 0;
+  
+  if(neq ==2) {
+    if((init0!=0) || (r0[0]!=0)) {
+      
+      pred0 = init0*exp(-ka*dt);//+ R0[0]*(1-exp(-ka*dt))/ka;
+      
+      if(ka > 0) { // new
+        pred0 += r0[0]*(1.0-exp(-ka*dt))/ka; // new
+        pred1 +=
+          polyexp<T>(dt,init0,0.0  ,0.0,0.0,false,a,alpha,2) +
+          polyexp<T>(dt,0.0  ,r0[0],dt ,0.0,false,a,alpha,2);
+      } else {
+        pred0 += r0[0]*dt; // new
+      }
+    }
+  }
+  
+  if((init1!=0) || (r0[1-eqoffset]!=0)) {
+    a[0] = 1;
+    pred1 +=
+      polyexp<T>(dt,init1,0.0  ,0.0,0.0,false,a,alpha,1) +
+      polyexp<T>(dt,0.0  ,r0[1-eqoffset],dt ,0.0,false,a,alpha,1);
+  }
+  
+  if(neq==2) {
+    y[0] = pred0;
+    y[1] = pred1;
+  }
+  if(neq==1) {
+    y[0] = pred1;
+  }
+}
+
+/**
+ * Advance the two-compartment model (advan 3 and 4) by <code>dt</code>.
+ * 
+ * @param ka absorption rate constant
+ * @param k10 elimination rate constant
+ * @param k12 central to peripheral rate constant
+ * @param k21 peripheral to central rate constant
+ * @param neq the number of compartments; 3 with a depot
+ * @param dt the time step
+ * @param y the amounts; updated
+ * @param r0 the infusion rates
+ * @param a scratch space for coefficients
+ * @param alpha scratch space for exponents
+ */
+template<typename T>
+static void advan4_calc(const T& ka, const T& k10, const T& k12, 
+                        const T& k21, const int neq, const double dt, 
+                        T* y, const double* r0,
+                        std::vector<T>& a, std::vector<T>& alpha) {
+  
+  T ksum = k10+k12+k21;
+  
+  T init0 = 0, init1 = 0, init2 = 0,  pred0 = 0, pred1 = 0, pred2 = 0;
+  
+  int eqoffset = 0;
+  
+  if(neq == 2) {
+    init0 = 0; init1 = y[0]; init2 = y[1];
+    eqoffset = 1;
+  }
+  if(neq ==3) {
+    init0 = y[0]; init1 = y[1]; init2 = y[2];
+  }
+  
+  alpha[0] = (ksum + sqrt(ksum*ksum-4.0*k10*k21))/2.0;
+  alpha[1] = (ksum - sqrt(ksum*ksum-4.0*k10*k21))/2.0;
+  alpha[2] = ka;
+  
+  if(neq==3) { // only do the absorption compartment if we have 3
+    if((init0 != 0) || (r0[0] != 0)) {
+      
+      pred0 = init0*exp(-ka*dt);// + R0[0]*(1.0-exp(-ka*dt))/ka;
+      
+      a[0] = ka*(k21-alpha[0])/((ka-alpha[0])*(alpha[1]-alpha[0]));
+      a[1] = ka*(k21-alpha[1])/((ka-alpha[1])*(alpha[0]-alpha[1]));
+      a[2] = -(a[0]+a[1]);
+      
+      if(ka > 0) {  // new
+        pred0 += r0[0]*(1.0-exp(-ka*dt))/ka; // new
+        pred1 +=
+          polyexp<T>(dt,init0,0,0,0,false,a,alpha,3) +
+          polyexp<T>(dt,0,r0[0],dt,0,false,a,alpha,3);
+        
+        a[0] = ka * k12/((ka-alpha[0])*(alpha[1]-alpha[0]));
+        a[1] = ka * k12/((ka-alpha[1])*(alpha[0]-alpha[1]));
+        a[2] = -(a[0] + a[1]);
+        
+        pred2 +=
+          polyexp<T>(dt,init0,0,0,0,false,a,alpha,3) +
+          polyexp<T>(dt,0,r0[0],dt,0,false,a,alpha,3);
+      } else {
+        pred0 += r0[0]*dt; // new
+      }
+    }
+  }
+  
+  if((init1 != 0) || (r0[1-eqoffset] != 0)) {
+    
+    a[0] = (k21 - alpha[0])/(alpha[1]-alpha[0]) ;
+    a[1] = (k21 - alpha[1])/(alpha[0]-alpha[1]) ;
+    
+    pred1 +=
+      polyexp<T>(dt,init1,0,0,0,false,a,alpha,2) +
+      polyexp<T>(dt,0,r0[1-eqoffset],dt,0,false,a,alpha,2);
+    
+    a[0] = k12/(alpha[1]-alpha[0]) ;
+    a[1] = -a[0];
+    
+    pred2 +=
+      polyexp<T>(dt,init1,0,0,0,false,a,alpha,2) +
+      polyexp<T>(dt,0,r0[1-eqoffset],dt,0,false,a,alpha,2);
+  }
+  
+  if((init2 != 0) || (r0[2-eqoffset] != 0)) {
+    
+    a[0] = k21/(alpha[1]-alpha[0]);
+    a[1] = -a[0];
+    
+    pred1 +=
+      polyexp<T>(dt,init2,0,0,0,false,a,alpha,2) +
+      polyexp<T>(dt,0,r0[2-eqoffset],dt,0,false,a,alpha,2);
+    
+    a[0] = (k10 + k12 - alpha[0])/(alpha[1]-alpha[0]);
+    a[1] = (k10 + k12 - alpha[1])/(alpha[0]-alpha[1]);
+    
+    pred2 +=
+      polyexp<T>(dt,init2,0,0,0,false,a,alpha,2) +
+      polyexp<T>(dt,0,r0[2-eqoffset],dt,0,false,a,alpha,2);
+  }
+  
+  if(neq ==2) {
+    y[0] = pred1;
+    y[1] = pred2;
+  }
+  if(neq ==3) {
+    y[0] = pred0;
+    y[1] = pred1;
+    y[2] = pred2;
+  }
+}
+
+/**
+ * Numerator of the Laplace transform of the three-compartment model 
+ * (central, first and second peripheral compartments as 0, 1 and 2): the 
+ * response in compartment <code>m</code> to a unit amount in compartment 
+ * <code>j</code> is this divided by <code>(s+alpha)(s+beta)(s+gamma)</code>.
+ */
+template<typename T>
+static T advan12_num(const int m, const int j, const T& s, const T& e1,
+                     const T& k12, const T& k21, const T& k13, 
+                     const T& k31) {
+  switch(3*m + j) {
+  case 0: return (s + k21)*(s + k31);
+  case 1: return k21*(s + k31);
+  case 2: return k31*(s + k21);
+  case 3: return k12*(s + k31);
+  case 4: return (s + e1)*(s + k31) - k13*k31;
+  case 5: return k31*k12;
+  case 6: return k13*(s + k21);
+  case 7: return k21*k13;
+  default: return (s + e1)*(s + k21) - k21*k12;
+  }
+}
+
+/**
+ * Advance the three-compartment model (advan 11 and 12) by 
+ * <code>dt</code>.  The exponents are the roots of the cubic 
+ * characteristic polynomial (trigonometric form) and, with a depot, 
+ * <code>ka</code>; the coefficients for each input and output compartment
+ * are the residues of the Laplace transform at the exponents.
+ * 
+ * @param ka absorption rate constant
+ * @param k10 elimination rate constant
+ * @param k12 central to first peripheral rate constant
+ * @param k21 first peripheral to central rate constant
+ * @param k13 central to second peripheral rate constant
+ * @param k31 second peripheral to central rate constant
+ * @param neq the number of compartments; 4 with a depot
+ * @param dt the time step
+ * @param y the amounts; updated
+ * @param r0 the infusion rates
+ * @param a scratch space for coefficients
+ * @param alpha scratch space for exponents
+ */
+template<typename T>
+static void advan12_calc(const T& ka, const T& k10, const T& k12, 
+                         const T& k21, const T& k13, const T& k31,
+                         const int neq, const double dt, T* y, 
+                         const double* r0, std::vector<T>& a, 
+                         std::vector<T>& alpha) {
+  
+  const T e1 = k10 + k12 + k13;
+  const T a0 = k10*k21*k31;
+  const T a1 = k10*k31 + k21*k31 + k21*k13 + k10*k21 + k31*k12;
+  const T a2 = e1 + k21 + k31;
+  const T p = a1 - a2*a2/3.0;
+  const T q = 2.0*a2*a2*a2/27.0 - a1*a2/3.0 + a0;
+  const T r1 = sqrt(-(p*p*p)/27.0);
+  T c = -q/(2.0*r1);
+  if(c > 1.0) c = 1.0;
+  if(c < -1.0) c = -1.0;
+  const T phi = acos(c)/3.0;
+  const T r2 = 2.0*exp(log(r1)/3.0);
+  const double third = 2.0*M_PI/3.0;
+  
+  alpha[0] = a2/3.0 - cos(phi)*r2;
+  alpha[1] = a2/3.0 - cos(phi + third)*r2;
+  alpha[2] = a2/3.0 - cos(phi + 2.0*third)*r2;
+  alpha[3] = ka;
+  
+  const int eqoffset = neq==3 ? 1 : 0;
+  
+  T pred[4] = {0, 0, 0, 0};
+  
+  if(neq==4) { // only do the absorption compartment if we have 4
+    const T init0 = y[0];
+    if((init0 != 0) || (r0[0] != 0)) {
+      pred[0] = init0*exp(-ka*dt);
+      if(ka > 0) {
+        pred[0] += r0[0]*(1.0-exp(-ka*dt))/ka;
+        for(int m = 0; m < 3; ++m) {
+          for(int i = 0; i < 4; ++i) {
+            a[i] = ka*advan12_num<T>(m, 0, -alpha[i], e1, k12, k21, k13, k31);
+            for(int k = 0; k < 4; ++k) {
+              if(k != i) a[i] = a[i]/(alpha[k] - alpha[i]);
+            }
+          }
+          pred[m+1] +=
+            polyexp<T>(dt,init0,0,0,0,false,a,alpha,4) +
+            polyexp<T>(dt,0,r0[0],dt,0,false,a,alpha,4);
+        }
+      } else {
+        pred[0] += r0[0]*dt;
+      }
+    }
+  }
+  
+  for(int j = 0; j < 3; ++j) {
+    const T init = y[j+1-eqoffset];
+    const double rate = r0[j+1-eqoffset];
+    if((init == 0) && (rate == 0)) continue;
+    for(int m = 0; m < 3; ++m) {
+      for(int i = 0; i < 3; ++i) {
+        a[i] = advan12_num<T>(m, j, -alpha[i], e1, k12, k21, k13, k31);
+        for(int k = 0; k < 3; ++k) {
+          if(k != i) a[i] = a[i]/(alpha[k] - alpha[i]);
+        }
+      }
+      pred[m+1] +=
+        polyexp<T>(dt,init,0,0,0,false,a,alpha,3) +
+        polyexp<T>(dt,0,rate,dt,0,false,a,alpha,3);
+    }
+  }
+  
+  for(int i = 0; i < neq; ++i) y[i] = pred[i + eqoffset];
+}
+
+void odeproblem::advan2(const double& tfrom, const double& tto) {
+  
+  double dt = tto-tfrom;
+  
+  if(MRGSOLVE_GET_PRED_CL <= 0) throw mrgsolve_error("pred_CL has a 0 or negative value.");
+  if(MRGSOLVE_GET_PRED_VC <= 0) throw mrgsolve_error("pred_VC has a 0 or negative value.");
+  
+  double k10 = MRGSOLVE_GET_PRED_K10;
+  double ka =  MRGSOLVE_GET_PRED_KA;
+  
+  if(k10 <= 0) throw mrgsolve_error("k10 has a 0 or negative value");
+  
+  if(Nsens > 0) this->advan_sens(dt);
+  
+  double k[2] = {k10, ka};
+  this->advan_pk(k, dt);
+}
+
+
+void odeproblem::advan4(const double& tfrom, const double& tto) {
+  
+  double dt = tto - tfrom;
+  
+  // Make sure parameters are valid
+  if (MRGSOLVE_GET_PRED_VC <=  0) throw mrgsolve_error("pred_VC has a 0 or negative  value.");
+  if (MRGSOLVE_GET_PRED_VP <=  0) throw mrgsolve_error("pred_VP has a 0 or negative  value.");
+  if (MRGSOLVE_GET_PRED_Q  <   0) throw mrgsolve_error("pred_Q has a  negative  value.");
+  if (MRGSOLVE_GET_PRED_CL <=  0) throw mrgsolve_error("pred_CL has a 0 or negative  value.");
+  
+  double ka =  MRGSOLVE_GET_PRED_KA;
+  double k10 = MRGSOLVE_GET_PRED_K10;
+  double k12 = MRGSOLVE_GET_PRED_K12;
+  double k21 = MRGSOLVE_GET_PRED_K21;
+  
+  if(Nsens > 0) this->advan_sens(dt);
+  
+  double k[4] = {ka, k10, k12, k21};
+  this->advan_pk(k, dt);
+}
+
+void odeproblem::advan12(const double& tfrom, const double& tto) {
+  
+  double dt = tto - tfrom;
+  
+  // Make sure parameters are valid
+  if (MRGSOLVE_GET_PRED_VC  <= 0) throw mrgsolve_error("pred_VC has a 0 or negative  value.");
+  if (MRGSOLVE_GET_PRED_VP  <= 0) throw mrgsolve_error("pred_VP has a 0 or negative  value.");
+  if (MRGSOLVE_GET_PRED_VP2 <= 0) throw mrgsolve_error("pred_VP2 has a 0 or negative  value.");
+  if (MRGSOLVE_GET_PRED_Q   <  0) throw mrgsolve_error("pred_Q has a  negative  value.");
+  if (MRGSOLVE_GET_PRED_Q4  <  0) throw mrgsolve_error("pred_Q4 has a  negative  value.");
+  if (MRGSOLVE_GET_PRED_CL  <= 0) throw mrgsolve_error("pred_CL has a 0 or negative  value.");
+  
+  // With no distribution the cubic has a double root at 0
+  if((MRGSOLVE_GET_PRED_Q == 0) && (MRGSOLVE_GET_PRED_Q4 == 0)) {
+    throw mrgsolve_error("pred_Q and pred_Q4 are both 0; use a one-compartment model.");
+  }
+  
+  double k[6] = {
+    MRGSOLVE_GET_PRED_KA, MRGSOLVE_GET_PRED_K10, MRGSOLVE_GET_PRED_K12, 
+    MRGSOLVE_GET_PRED_K21, MRGSOLVE_GET_PRED_K13, MRGSOLVE_GET_PRED_K31
+  };
+  
+  if(Nsens > 0) this->advan_sens(dt);
+  
+  this->advan_pk(k, dt);
+}
+
+//! number of time steps kept in the advan 1/2/3/4/11/12 cache
+#define PK_CACHE 8
+
+/**
+ * Advance a <code>$PKMODEL</code> model by <code>dt</code>.  The closed 
+ * form solution is linear in the starting amounts and the infusion rates,
+ * <code>y(dt) = P y(0) + Q R0</code>, so <code>P</code> and 
+ * <code>Q</code> are found once from unit amounts and rates and kept for 
+ * the last few time steps until the rate constants change.  Records on a 
+ * regular grid only cost the matrix products.  Compartments with no 
+ * amount and no infusion are skipped, as in the closed form.
+ * 
+ * @param k the rate constants: <code>k10</code> and <code>ka</code> for 
+ * advan 1 and 2; <code>ka</code>, <code>k10</code>, <code>k12</code> and 
+ * <code>k21</code> for advan 3 and 4; those and <code>k13</code> and
+ * <code>k31</code> for advan 11 and 12
+ * @param dt the time step
+ */
+void odeproblem::advan_pk(const double* k, const double dt) {
+  const size_t nk = Advan <= 2 ? 2 : (Advan <= 4 ? 4 : 6);
+  
+  bool same = Pk_key.size()==nk;
+  for(size_t i = 0; same && i < nk; ++i) same = Pk_key[i]==k[i];
+  if(!same) {
+    Pk_key.assign(k, k + nk);
+    Pk_dt.clear();
+    Pk_next = 0;
+  }
+  
+  int slot = -1;
+  for(size_t i = 0; i < Pk_dt.size(); ++i) {
+    if(Pk_dt[i]==dt) {
+      slot = i;
+      break;
+    }
+  }
+  
+  const int n = Neq;
+  
+  if(slot < 0) {
+    if(Pk_dt.size() < PK_CACHE) {
+      Pk_dt.push_back(dt);
+      slot = Pk_dt.size() - 1;
+      if(Pk_mat.size() <= size_t(slot)) Pk_mat.push_back(dvec());
+    } else {
+      slot = Pk_next;
+      Pk_next = (Pk_next + 1) % PK_CACHE;
+      Pk_dt[slot] = dt;
+    }
+    dvec& m = Pk_mat[slot];
+    m.assign(2*n*n, 0.0);
+    dvec y(n, 0.0), r(n, 0.0);
+    for(int j = 0; j < 2*n; ++j) {
+      std::fill(y.begin(), y.end(), 0.0);
+      std::fill(r.begin(), r.end(), 0.0);
+      if(j < n) {
+        y[j] = 1.0;
+      } else {
+        r[j-n] = 1.0;
+      }
+      if(Advan <= 2) {
+        advan2_calc<double>(k[0], k[1], n, dt, &y[0], &r[0], a, alpha);
+      } else if(Advan <= 4) {
+        advan4_calc<double>(k[0], k[1], k[2], k[3], n, dt, &y[0], &r[0], 
+                            a, alpha);
+      } else {
+        advan12_calc<double>(k[0], k[1], k[2], k[3], k[4], k[5], n, dt, 
+                             &y[0], &r[0], a, alpha);
+      }
+      for(int i = 0; i < n; ++i) m[i + j*n] = y[i];
+    }
+  }
+  
+  const double* P = &Pk_mat[slot][0];
+  const double* Q = P + n*n;
+  for(int i = 0; i < n; ++i) {
+    Pk_y[i] = Y[i];
+    Y[i] = 0.0;
+  }
+  for(int j = 0; j < n; ++j) {
+    if(Pk_y[j] != 0) {
+      for(int i = 0; i < n; ++i) Y[i] += P[i + j*n]*Pk_y[j];
+    }
+    if(R0[j] != 0) {
+      for(int i = 0; i < n; ++i) Y[i] += Q[i + j*n]*R0[j];
+    }
+  }
+}
+
+/**
+ * Advance the sensitivities for <code>$PKMODEL</code> models by 
+ * <code>dt</code>.  The closed form solution is differentiated exactly: 
+ * it is evaluated with <code>dual</code> numbers that start from the 
+ * amounts and their sensitivities, with the derivatives of the PK 
+ * parameters in <code>pred</code> from <code>main_sens</code>.  
+ * Call before the amounts are advanced.
+ * 
+ * @param dt the time step
+ */
+void odeproblem::advan_sens(const double dt) {
+  const size_t np = pred.size();
+  for(int k = 0; k < Nsens; ++k) {
+    for(size_t j = 0; j < np; ++j) {
+      Sens_pk[j] = dual(pred[j], Sens_dpred[np*k + j]);
+    }
+    double* s = Y + Neq*(k+1);
+    for(int i = 0; i < Neq; ++i) Sens_state[i] = dual(Y[i], s[i]);
+    const dual& cl = Sens_pk[0];
+    const dual& vc = Sens_pk[1];
+    const dual& ka = Sens_pk[2];
+    if(Advan <= 2) {
+      advan2_calc<dual>(cl/vc, ka, Neq, dt, &Sens_state[0], &R0[0], 
+                        Sens_a, Sens_alpha);
+    } else if(Advan <= 4) {
+      const dual& q = Sens_pk[3];
+      const dual& vp = Sens_pk[4];
+      advan4_calc<dual>(ka, cl/vc, q/vc, q/vp, Neq, dt, &Sens_state[0], 
+                        &R0[0], Sens_a, Sens_alpha);
+    } else {
+      const dual& q = Sens_pk[3];
+      const dual& vp = Sens_pk[4];
+      const dual& q2 = Sens_pk[5];
+      const dual& vp2 = Sens_pk[6];
+      advan12_calc<dual>(ka, cl/vc, q/vc, q/vp, q2/vc, q2/vp2, Neq, dt, 
+                         &Sens_state[0], &R0[0], Sens_a, Sens_alpha);
+    }
+    for(int i = 0; i < Neq; ++i) s[i] = Sens_state[i].d;
+  }
+}
+
 void odeproblem::copy_parin(const Rcpp::List& parin) {
   this->tol(Rcpp::as<double>(parin["atol"]),Rcpp::as<double>(parin["rtol"]));
   this->hmax(Rcpp::as<double>(parin["hmax"]));
@@ -671,6 +1661,197 @@ void odeproblem::copy_parin(const Rcpp::List& parin) {
   this->mxhnil(Rcpp::as<double>  (parin["mxhnil"]));
   this->advan(Rcpp::as<int>(parin["advan"]));
   Do_Init_Calc = Rcpp::as<bool>(parin["do_init_calc"]);
+  Ss_n = Rcpp::as<int>(parin["ss_n"]);
+  Ss_rtol = Rcpp::as<double>(parin["ss_rtol"]);
+  Ss_atol = Rcpp::as<double>(parin["ss_atol"]);
+  Ss_report = Rcpp::as<bool>(parin["ss_report"]);
+  Ss_cache = Rcpp::as<bool>(parin["ss_cache"]);
+  this->solver(Rcpp::as<int>(parin["solver"]));
+  this->copy_sens(parin["sens"]);
+  Nroot = Rcpp::as<int>(parin["nroot"]);
+  Root_lo.assign(Nroot, 0.0);
+  Root_hi.assign(Nroot, 0.0);
+  Root_mid.assign(Nroot, 0.0);
+  Root_sign.assign(Nroot, 0);
+  Root_y.assign(Nsys, 0.0);
+}
+
+/**
+ * Set up sensitivities with respect to model parameters.  For 
+ * <code>$ODE</code> models the sensitivities are integrated by the 
+ * solver along with the amounts, so the solver takes 
+ * <code>Neq</code> more equations for each parameter; the sensitivities 
+ * for parameter <code>k</code> follow the amounts in the state vector.  
+ * For <code>$PKMODEL</code> models, the sensitivities come from the 
+ * closed form solution through the PK parameters in <code>pred</code>.  
+ * Either way, the derivatives come from the <code>dual</code> copies of 
+ * the model functions that models get with <code>$PLUGIN sens</code>.  
+ * With sensitivities, the solver always gets its Jacobian from 
+ * <code>call_jac</code>.
+ * 
+ * @param sens parameter positions (C++ indexing)
+ */
+void odeproblem::copy_sens(const Rcpp::IntegerVector& sens) {
+  Nsens = sens.size();
+  Sens_par.assign(sens.begin(), sens.end());
+  for(int k = 0; k < Nsens; ++k) {
+    if((Sens_par[k] < 0) || (Sens_par[k] >= Npar)) {
+      throw mrgsolve_error("sensitivity parameter is out of range.");
+    }
+  }
+  if(Nsens > 0 && (Vars==NULL || InitsSens==NULL || DerivsSens==NULL || 
+                   TableSens==NULL)) {
+    throw mrgsolve_error(
+        "the model needs $PLUGIN sens to get sensitivities."
+    );
+  }
+  this->nsys(Neq*(1 + Nsens));
+  xjt = (Jac==NULL && Nsens==0) ? 2 : 1;
+  const int neq = Neq > 0 ? Neq : 1;
+  Warm_y.assign(Nsys, 0.0);
+  Warm_dxdt.assign(Nsys, 0.0);
+  Sens_y.assign(Neq, 0.0);
+  Sens_f0.assign(Neq, 0.0);
+  Sens_jac.assign(Nsens > 0 ? Neq*Neq : 0, 0.0);
+  Sens_capture.assign(Capture.size()*Nsens, 0.0);
+  Sens_theta.assign(Npar > 0 ? Npar : 1, dual());
+  Sens_amt.assign(neq, dual());
+  Sens_dadt.assign(neq, dual());
+  Sens_init.assign(Neq, dual());
+  Sens_dinit.assign(neq*Nsens, 0.0);
+  Sens_a0.assign(Neq, dual());
+  Sens_da0.assign(neq*Nsens, 0.0);
+  Sens_F.assign(Neq, dual());
+  Sens_alag.assign(Neq, dual());
+  Sens_R.assign(Neq, dual());
+  Sens_D.assign(Neq, dual());
+  Sens_pred.assign(pred.size(), dual());
+  Sens_dpred.assign(pred.size()*Nsens, 0.0);
+  Sens_cap.assign(Capture.size(), dual());
+  Sens_v0.assign(Nvars > 0 ? Nvars : 1, 0.0);
+  Sens_v.assign(Nvars > 0 ? Nvars : 1, dual());
+  Sens_dvars.assign(Nvars > 0 ? Nvars*Nsens : 1, 0.0);
+  Sens_w.assign(Nsensw > 0 ? Nsensw : 1, dual());
+  Sens_state.assign(Neq, dual());
+  Sens_pk.assign(pred.size(), dual());
+  Sens_a.assign(a.size(), dual());
+  Sens_alpha.assign(alpha.size(), dual());
+}
+
+/**
+ * Record the outcome of bringing the system to steady state.  Records 
+ * that didn't converge are always counted; the details are only kept 
+ * when a report was requested.
+ * 
+ * @param time the record time
+ * @param cmt the record compartment
+ * @param iter the number of dosing intervals that were simulated
+ * @param converged whether or not steady state was reached
+ * @param cached whether or not the result came from the cache
+ */
+void odeproblem::ss_log(const double time, const int cmt, const int iter, 
+                        const bool converged, const bool cached) {
+  if(!converged) ++Ss_fail;
+  if(!Ss_report) return;
+  ssinfo info;
+  info.idn = d.idn;
+  info.id = d.id;
+  info.time = time;
+  info.cmt = cmt;
+  info.iter = iter;
+  info.converged = converged;
+  info.cached = cached;
+  Ss_log.push_back(info);
+}
+
+/**
+ * Build the key for saving the steady state result for a dosing record.
+ * 
+ * The key holds everything the result depends on: the dose, the 
+ * compartment, bioavailability, lag time, parameters, <code>ETA</code> 
+ * and the values in <code>pred</code>.  For <code>$ODE</code> models, 
+ * the result also depends on the amounts we start from and on anything 
+ * in <code>$MAIN</code> that depends on time, so those go in the key 
+ * too.
+ * 
+ * @param key the key
+ * @param rec the steady state dosing record
+ * @param duration the infusion duration; 0 for a bolus
+ * @return <code>false</code> if the cache is turned off
+ */
+bool odeproblem::ss_cache_key(dvec& key, rec_ptr rec, const double duration) {
+  if(!Ss_cache) return false;
+  const int cmtn = rec->cmtn();
+  key.clear();
+  key.reserve(12 + Npar + d.ETA.size() + pred.size() + Neq);
+  key.push_back(Advan);
+  key.push_back(Neq);
+  key.push_back(rec->cmt());
+  key.push_back(rec->amt());
+  key.push_back(rec->rate());
+  key.push_back(rec->ii());
+  key.push_back(rec->ss());
+  key.push_back(duration);
+  key.push_back(this->fbio(cmtn));
+  key.push_back(this->alag(cmtn));
+  key.insert(key.end(), Param, Param + Npar);
+  key.insert(key.end(), d.ETA.begin(), d.ETA.end());
+  key.insert(key.end(), pred.begin(), pred.end());
+  if(Advan==13) {
+    key.push_back(rec->time());
+    key.insert(key.end(), Y, Y + Neq);
+  }
+  return true;
+}
+
+/**
+ * Replay a saved steady state result.
+ * 
+ * @param key the key from <code>ss_cache_key</code>
+ * @param tfrom start of the last interval
+ * @param tto end of the last interval
+ * @param iter dosing intervals simulated
+ * @param converged whether or not steady state was reached
+ * @return <code>true</code> if a result was found; the amounts are set 
+ * to the saved steady state.  Hits and misses are counted here.
+ */
+bool odeproblem::ss_cache_get(const dvec& key, double& tfrom, double& tto, 
+                              int& iter, bool& converged) {
+  std::map<dvec,sscache>::const_iterator it = Ss_saved.find(key);
+  if(it==Ss_saved.end()) {
+    ++Ss_misses;
+    return false;
+  }
+  const sscache& c = it->second;
+  for(int i=0; i < Nsys; ++i) Y[i] = c.y[i];
+  tfrom = c.tfrom;
+  tto = c.tto;
+  iter = c.iter;
+  converged = c.converged;
+  ++Ss_hits;
+  return true;
+}
+
+/**
+ * Save the current amounts as the steady state result for a key.  Nothing 
+ * is saved once the cache is full.
+ * 
+ * @param key the key from <code>ss_cache_key</code>
+ * @param tfrom start of the last interval
+ * @param tto end of the last interval
+ * @param iter dosing intervals simulated
+ * @param converged whether or not steady state was reached
+ */
+void odeproblem::ss_cache_put(const dvec& key, const double tfrom, 
+                              const double tto, const int iter, 
+                              const bool converged) {
+  if(Ss_saved.size() >= MRGSOLVE_SS_CACHE_MAX) return;
+  sscache& c = Ss_saved[key];
+  c.y.assign(Y, Y + Nsys);
+  c.tfrom = tfrom;
+  c.tto = tto;
+  c.iter = iter;
+  c.converged = converged;
 }
 
 void odeproblem::copy_funs(const Rcpp::List& funs) {
@@ -678,13 +1859,23 @@ void odeproblem::copy_funs(const Rcpp::List& funs) {
   *reinterpret_cast<void**>(&Table)  = R_ExternalPtrAddr(funs["table"]);
   *reinterpret_cast<void**>(&Derivs) = R_ExternalPtrAddr(funs["ode"]);
   *reinterpret_cast<void**>(&Config) = R_ExternalPtrAddr(funs["config"]);
+  this->copy_jac(funs);
+  this->copy_root(funs);
+  this->copy_vars(funs);
+  this->copy_sens_funs(funs);
 }
 
 void odeproblem::advan(int x) {
   Advan = x;
   
+  Pk_key.clear();
+  Pk_dt.clear();
+  Pk_next = 0;
+  
   if(Advan==13) return;
   
+  Pk_y.assign(Neq, 0.0);
+  
   if((x==1) | (x ==2)) {
     a.assign(2,0.0);
     alpha.assign(2,0.0);
@@ -694,6 +1885,11 @@ void odeproblem::advan(int x) {
     a.assign(3,0.0);
     alpha.assign(3,0.0);
   }
+  
+  if((x==11) | (x==12)) {
+    a.assign(4,0.0);
+    alpha.assign(4,0.0);
+  }
 }
 
 /**
@@ -742,18 +1938,95 @@ Rcpp::List TOUCH_FUNS(const Rcpp::NumericVector& lparam,
 }
 
 void odeproblem::omega(Rcpp::NumericMatrix& x) {
-  Omega = Rcpp::as<arma::mat>(x);
+  Omega.set(Rcpp::as<arma::mat>(x));
 }
 
 void odeproblem::sigma(Rcpp::NumericMatrix& x) {
-  Sigma = Rcpp::as<arma::mat>(x);
+  Sigma.set(Rcpp::as<arma::mat>(x));
 }
 
 arma::mat odeproblem::mv_omega(int n) {
-  return MVGAUSS(Omega,n);
+  return Omega.draw(n);
+}
+
+/**
+ * Seed the per-subject random streams.  ETA and <code>simeta()</code> 
+ * come from the streams when <code>eta</code> is <code>true</code>; EPS 
+ * and <code>simeps()</code> when <code>eps</code> is <code>true</code>.  
+ * Otherwise they are drawn from the R random number generator.  Draws for 
+ * a subject from the streams depend only on the seed, the subject ID and 
+ * the position of the draw within that subject, so they don't change with 
+ * the order in which subjects are simulated.
+ * 
+ * @param seed the seed for the streams
+ * @param eta if <code>true</code>, draw ETA from the streams
+ * @param eps if <code>true</code>, draw EPS from the streams
+ */
+void odeproblem::stream_seed(const int seed, const bool eta, const bool eps) {
+  Streaming = eta;
+  Stream_eps = eps;
+  Eps_row = -1;
+  Rng.seed(static_cast<uint32_t>(seed));
+}
+
+void odeproblem::stream_draw(const mvgauss& mv, dvec& x,
+                             const uint32_t stream, const uint32_t record) {
+  if(mv.size()==0) return;
+  Rng.set(d.id, stream, record);
+  Stream_z.resize(mv.size());
+  for(unsigned int i = 0; i < mv.size(); ++i) Stream_z[i] = Rng.rnorm();
+  mv.apply(&Stream_z[0], &x[0]);
+}
+
+/**
+ * Draw ETA for the current subject.
+ */
+void odeproblem::stream_eta() {
+  stream_draw(Omega, d.ETA, 0, 0);
+}
+
+/**
+ * Draw EPS for the current subject.
+ * 
+ * Without the streams, one draw of all the EPS is taken from the R 
+ * random number generator for every output row up to <code>row</code>, 
+ * in row order; <code>simeps()</code> calls for a row take their draws 
+ * after the ones for that row.  Rows that come back to a row that was already passed (like the 
+ * ones of another branch from a checkpoint) get a new draw.
+ * 
+ * @param record the output row for the subject, starting at 0
+ * @param row the output row in the simulated data
+ */
+void odeproblem::draw_eps(const unsigned int record, const unsigned int row) {
+  if(Stream_eps) {
+    stream_draw(Sigma, d.EPS, 1, record);
+    return;
+  }
+  if(Sigma.size()==0) return;
+  const long r = row;
+  if(r == Eps_row) return;
+  long n = r > Eps_row ? r - Eps_row : 1;
+  for(; n > 0; --n) this->r_simeps();
+  Eps_row = r;
+}
+
+/**
+ * Draw EPS from the R random number generator.
+ */
+void odeproblem::r_simeps() {
+  arma::mat eps = Sigma.draw(1);
+  for(unsigned int i=0; i < eps.n_cols; ++i) {
+    d.EPS[i] = eps(0,i);
+  }
+}
+
+void odeproblem::stream_simeta() {
+  stream_draw(Omega, d.ETA, 2, Resim_eta);
+  ++Resim_eta;
 }
 
-arma::mat odeproblem::mv_sigma(int n) {
-  return MVGAUSS(Sigma,n);
+void odeproblem::stream_simeps() {
+  stream_draw(Sigma, d.EPS, 3, Resim_eps);
+  ++Resim_eps;
 }
 
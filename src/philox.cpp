@@ -0,0 +1,124 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file philox.cpp
+ */
+
+#include <cmath>
+#include <cstring>
+#include "philox.h"
+
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+
+//! second key word for replicate 0
+#define PHILOX_KEY1 0x6D72676FU
+
+//! number of low bits in the last counter word that count blocks
+#define PHILOX_BLOCK_BITS 28
+
+philox::philox() {
+  seed(0);
+}
+
+philox::philox(const uint32_t seed_) {
+  seed(seed_);
+}
+
+void philox::seed(const uint32_t seed_) {
+  Key[0] = seed_;
+  Key[1] = PHILOX_KEY1;
+  set(0.0, 0, 0);
+}
+
+/**
+ * Switch to the streams for a replicate of the simulation.  Replicate 0
+ * is what <code>seed</code> sets up.
+ *
+ * @param rep the replicate number
+ */
+void philox::replicate(const uint32_t rep) {
+  Key[1] = PHILOX_KEY1 + rep;
+  Nnorm = 0;
+}
+
+/**
+ * Position the generator at the start of a stream.
+ *
+ * @param id the subject ID
+ * @param stream the stream number (0 through 15)
+ * @param record the record number
+ */
+void philox::set(const double id, const uint32_t stream,
+                 const uint32_t record) {
+  // Use the bits of the ID so that non-integer IDs get their own streams
+  double id_ = id == 0.0 ? 0.0 : id;
+  uint64_t bits;
+  std::memcpy(&bits, &id_, sizeof(bits));
+  Ctr[0] = static_cast<uint32_t>(bits);
+  Ctr[1] = static_cast<uint32_t>(bits >> 32);
+  Ctr[2] = record;
+  Ctr[3] = (stream & 0xFU) << PHILOX_BLOCK_BITS;
+  Nnorm = 0;
+}
+
+void philox::next_block() {
+  uint32_t c0 = Ctr[0], c1 = Ctr[1], c2 = Ctr[2], c3 = Ctr[3];
+  uint32_t k0 = Key[0], k1 = Key[1];
+  for(int r = 0; r < 10; ++r) {
+    uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+    uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+    uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+    uint32_t lo0 = static_cast<uint32_t>(p0);
+    uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+    uint32_t lo1 = static_cast<uint32_t>(p1);
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = lo1;
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = lo0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  Out[0] = c0;
+  Out[1] = c1;
+  Out[2] = c2;
+  Out[3] = c3;
+  ++Ctr[3];
+}
+
+/**
+ * Draw a standard normal deviate (Box-Muller; two deviates per block).
+ */
+double philox::rnorm() {
+  if(Nnorm > 0) {
+    --Nnorm;
+    return Norm[Nnorm];
+  }
+  next_block();
+  uint64_t a = (static_cast<uint64_t>(Out[0]) << 21) ^ (Out[1] >> 11);
+  uint64_t b = (static_cast<uint64_t>(Out[2]) << 21) ^ (Out[3] >> 11);
+  double u1 = (static_cast<double>(a) + 0.5) / 9007199254740992.0;
+  double u2 = (static_cast<double>(b) + 0.5) / 9007199254740992.0;
+  double r = std::sqrt(-2.0 * std::log(u1));
+  double theta = 6.283185307179586476925286766559 * u2;
+  Norm[0] = r * std::sin(theta);
+  Nnorm = 1;
+  return r * std::cos(theta);
+}
@@ -0,0 +1,932 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file simrun.cpp
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+#include <cfloat>
+#include "mrgsolve.h"
+#include "odeproblem.h"
+#include "dataobject.h"
+#include "simrun.h"
+#include "RcppInclude.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+simrun::simrun(dataobject* dat_, dataobject* idat_, Rcpp::NumericMatrix& ans_) {
+  dat = dat_;
+  idat = idat_;
+  output(ans_);
+  tad = false;
+  nocb = true;
+  filbak = false;
+  addl_ev_first = true;
+  mindt = 0;
+  dense = false;
+  replicate = false;
+  neq = 0;
+  neta = 0;
+  neps = 0;
+  capture_start = 0;
+  req_start = 0;
+  nsens = 0;
+  sens_start = 0;
+}
+
+simrun::~simrun() {
+  for(size_t i = 0; i < Pools.size(); ++i) delete Pools[i];
+  for(size_t i = 0; i < Copies.size(); ++i) delete Copies[i];
+}
+
+/**
+ * Set the matrix that simulated rows are written to.  It has to have the
+ * same layout as the matrix the object was created with.
+ *
+ * @param ans_ the output matrix
+ */
+void simrun::output(Rcpp::NumericMatrix& ans_) {
+  Ans = ans_.begin();
+  Ans_nrow = ans_.nrow();
+  Ans_ncol = ans_.ncol();
+  NN = Ans_nrow;
+}
+
+/**
+ * Save the positions in the capture vector that go into the output.
+ *
+ * @param capture_ capture indices; the first element is the size of the
+ * capture vector and is skipped
+ * @param start the first output column for captured items
+ */
+void simrun::capture(const Rcpp::IntegerVector& capture_, unsigned int start) {
+  Capture.assign(capture_.begin() + 1, capture_.end());
+  capture_start = start;
+}
+
+/**
+ * Save the compartments that go into the output.
+ *
+ * @param request_ compartment indices (C++ indexing)
+ * @param start the first output column for compartments
+ */
+void simrun::request(const Rcpp::IntegerVector& request_, unsigned int start) {
+  Request.assign(request_.begin(), request_.end());
+  req_start = start;
+}
+
+/**
+ * Set up the sensitivity columns: for each parameter, the sensitivities 
+ * of the requested compartments followed by those of the captured items.
+ *
+ * @param nsens_ the number of parameters with sensitivities
+ * @param start the first output column for sensitivities
+ */
+void simrun::sens(const unsigned int nsens_, unsigned int start) {
+  nsens = nsens_;
+  sens_start = start;
+}
+
+/**
+ * Find the first output row for each subject.  Records have to be in
+ * place (including observations from the time grid) before calling;
+ * records that get added during the simulation never go into the output.
+ *
+ * @param a the record stack
+ */
+void simrun::first_rows(const recstack& a) {
+  firstrow.assign(a.size(), 0);
+  unsigned int crow = 0;
+  for(size_t i = 0; i < a.size(); ++i) {
+    firstrow[i] = crow;
+    for(reclist::const_iterator it = a[i].begin(); it != a[i].end(); ++it) {
+      if((*it)->output()) ++crow;
+    }
+  }
+}
+
+void simrun::output_row(const unsigned int crow, const double id,
+                        const double time, odeproblem* prob) {
+  Ans[crow] = id;
+  Ans[crow + Ans_nrow] = time;
+  for(size_t k = 0; k < Capture.size(); ++k) {
+    Ans[crow + (k + capture_start)*Ans_nrow] = prob->capture(Capture[k]);
+  }
+  for(size_t k = 0; k < Request.size(); ++k) {
+    Ans[crow + (k + req_start)*Ans_nrow] = prob->y(Request[k]);
+  }
+  unsigned int col = sens_start;
+  for(unsigned int s = 0; s < nsens; ++s) {
+    for(size_t k = 0; k < Request.size(); ++k, ++col) {
+      Ans[crow + col*Ans_nrow] = prob->sens_y(Request[k], s);
+    }
+    for(size_t k = 0; k < Capture.size(); ++k, ++col) {
+      Ans[crow + col*Ans_nrow] = prob->sens_capture(Capture[k], s);
+    }
+  }
+}
+
+/**
+ * Simulate one subject.
+ *
+ * Records that are created while simulating the subject (lagged doses,
+ * additional doses, infusion ends and modeled events) are queued in a
+ * <code>recheap</code> and merged with the data set records as the 
+ * simulation moves forward, so the subject's records are never re-sorted.
+ * Additional doses are queued one at a time and records are handed back 
+ * to the pool once they are done, so the number of records held for a
+ * subject depends on the number of pending events, not on the length of 
+ * the dosing history.
+ *
+ * @param i the subject index
+ * @param recs records for this subject
+ * @param prob the odeproblem object to use
+ * @param crow the first output row for this subject
+ * @param pool storage for records that are created for this subject; 
+ * the pool is cleared first
+ * @param rep the replicate; ETAs come from row 
+ * <code>rep*nid + i</code> of <code>eta</code>
+ * @param save if not <code>NULL</code>, the subject is simulated up to the
+ * first record at or after the checkpoint time and saved there; doses that
+ * were scheduled before the checkpoint are kept past the last record
+ * @param from if not <code>NULL</code>, the subject is picked up from this
+ * checkpoint and <code>recs</code> are the records from the checkpoint 
+ * time on; output starts at <code>crow</code>
+ * @param data the data set that <code>recs</code> come from; 
+ * <code>NULL</code> for the data set of the run
+ */
+void simrun::id(const size_t i, reclist& recs, odeproblem* prob,
+                unsigned int crow, recpool& pool, const size_t rep,
+                checkpoint* save, const checkpoint* from, dataobject* data) {
+
+  double tto, tfrom;
+  int this_cmtn = 0;
+  double dt = 0;
+  double Fn = 1.0;
+  double told = -1;
+  bool locf = false;
+  unsigned int k = 0;
+  reclist mtimehx;
+  recheap future;
+  CompRec before;
+  double maxtime;
+  unsigned int crow0 = crow;
+
+  if(data == NULL) data = dat;
+
+  pool.clear();
+
+  prob->idn(i);
+
+  const double id = dat->get_uid(i);
+
+  if(from != NULL) {
+
+    prob->restore(from->state);
+    prob->nid(dat->nid());
+    prob->nrow(NN);
+    prob->idn(i);
+
+    tfrom = from->tfrom;
+    told = from->told;
+    crow0 = crow - from->rows;
+    maxtime = recs.empty() ? from->last : recs.back()->time();
+
+    // Additional doses past the last record wouldn't have been scheduled
+    for(size_t r = 0; r < from->pending.size(); ++r) {
+      rec_ptr rec = pool.make(from->pending[r]);
+      if(rec->addl_dose() && (rec->time() > maxtime)) {
+        pool.release(rec);
+        continue;
+      }
+      future.push(rec);
+    }
+    for(size_t r = 0; r < from->modeled.size(); ++r) {
+      mtimehx.push_back(pool.make(from->modeled[r]));
+    }
+
+  } else {
+
+    if(recs.empty() || ((save != NULL) && (recs.front()->time() >= save->time))) {
+      std::ostringstream msg;
+      msg << "ID " << id << " has no records before the checkpoint time.";
+      throw mrgsolve_error(msg.str());
+    }
+
+    tfrom = recs.front()->time();
+    maxtime = recs.back()->time();
+
+    prob->reset_newid(id);
+
+    if(i==0) {
+      prob->newind(0);
+    }
+
+    if(prob->streaming()) {
+      prob->stream_eta();
+    } else {
+      const size_t row = rep*dat->nid() + i;
+      for(k=0; k < neta; ++k) prob->eta(k,eta(row,k));
+    }
+    prob->draw_eps(0, crow);
+
+    if(idat != NULL) {
+      idat->copy_parameters(idat->get_idata_row(id),prob);
+    }
+
+    if(recs[0]->from_data()) {
+      dat->copy_parameters(recs[0]->pos(), prob);
+    } else {
+      if(filbak) {
+        dat->copy_parameters(dat->start(i),prob);
+      }
+    }
+
+    prob->y_init(init);
+
+    if(idat != NULL) {
+      idat->copy_inits(idat->get_idata_row(id),prob);
+    }
+    prob->set_d(recs[0]);
+    prob->init_call(tfrom);
+  }
+
+  // Doses are scheduled up to the last record; when saving, the rest of 
+  // the records come later so nothing is cut off
+  const double horizon = (save != NULL) ? DBL_MAX : maxtime;
+
+  // Time of the next data set event at or after each record; with dense
+  // output, the solver steps over the observations in between and fills
+  // them by interpolation
+  dvec next_event(recs.size() + 1, maxtime);
+  for(size_t r = recs.size(); r > 0; --r) {
+    next_event[r-1] = recs[r-1]->is_event() ? recs[r-1]->time() : next_event[r];
+  }
+
+  size_t jd = 0;
+  rec_ptr done = NULL;
+
+  // Records interrupted by a $ROOT crossing; they are simulated again
+  // after the crossing but their doses are already scheduled
+  reclist resumed;
+  rec_ptr root_rec = NULL;
+  int root_k = 0;
+
+  for(size_t j = (from == NULL) ? 0 : 1; (jd < recs.size()) || !future.empty(); ++j) {
+
+    // The last record came off the queue; give it back unless it is still
+    // needed to check for duplicate modeled events
+    if(done != NULL) {
+      if(std::find(mtimehx.begin(),mtimehx.end(),done) == mtimehx.end()) {
+        pool.release(done);
+      }
+      done = NULL;
+    }
+
+    rec_ptr this_rec;
+    if(future.empty() || 
+       ((jd < recs.size()) && !before(future.top(), recs[jd]))) {
+      if((save != NULL) && (recs[jd]->time() >= save->time)) break;
+      this_rec = recs[jd];
+      ++jd;
+    } else {
+      if((save != NULL) && (future.top()->time() >= save->time)) break;
+      this_rec = future.top();
+      future.pop();
+      done = this_rec;
+    }
+
+    // A record interrupted by a $ROOT crossing comes around once more; its
+    // doses (and the next additional dose) are already scheduled
+    bool again = false;
+    reclist::iterator it = std::find(resumed.begin(),resumed.end(),this_rec);
+    if(it != resumed.end()) {
+      again = true;
+      resumed.erase(it);
+    }
+    if((done == this_rec) && !again) {
+      this_rec->schedule_next(future, pool, horizon);
+    }
+
+    if(crow == NN) continue;
+
+    prob->rown(crow);
+
+    if(prob->systemoff()) {
+      unsigned short int status = prob->systemoff();
+      if(status==9) throw mrgsolve_error("the problem was stopped at user request.");
+      if(status==999) throw mrgsolve_error("999 sent from the model");
+      if(this_rec->output()) {
+        if(status==1) {
+          output_row(crow, id, this_rec->time(), prob);
+        } else {
+          for(unsigned int k=0; k < Ans_ncol; ++k) {
+            Ans[crow + k*Ans_nrow] = NA_REAL;
+          }
+        }
+        ++crow;
+      }
+      continue;
+    }
+
+    locf = false;
+    if(this_rec->from_data()) {
+      if(nocb) {
+        data->copy_parameters(this_rec->pos(), prob);
+      } else {
+        locf = true;
+      }
+    }
+
+    tto = this_rec->time();
+
+    dt  = (tto-tfrom)/(tfrom == 0.0 ? 1.0 : tfrom);
+
+    if((dt > 0.0) && (dt < mindt)) {
+      tto = tfrom;
+    }
+
+    if(tto > tfrom) {
+      prob->draw_eps(crow - crow0, crow);
+    }
+
+    if(j != 0) {
+      prob->newind(2);
+      prob->set_d(this_rec);
+      if(this_rec == root_rec) {
+        prob->root_fired(root_k);
+        root_rec = NULL;
+      }
+      prob->init_call_record(tto);
+    }
+
+    // Some non-observation event happening
+    if(this_rec->is_event() && !again) {
+
+      this_cmtn = this_rec->cmtn();
+
+      Fn = prob->fbio(this_cmtn);
+
+      if(Fn < 0) {
+        throw mrgsolve_error("mrgsolve: bioavailability fraction is less than zero.");
+      }
+
+      if(this_rec->from_data()) {
+
+        if(this_rec->rate() < 0) {
+          prob->rate_main(this_rec);
+        }
+
+        if(prob->alag(this_cmtn) > mindt) { // there is a valid lagtime
+
+          if(this_rec->ss() > 0) {
+            this_rec->steady(prob, Fn);
+            tfrom = tto;
+          }
+          rec_ptr newev = pool.make(*this_rec);
+          newev->pos(__ALAG_POS);
+          newev->phantom_rec();
+          newev->time(this_rec->time() + prob->alag(this_cmtn));
+          newev->ss(0);
+          future.push(newev);
+          newev->schedule(future, pool, horizon, addl_ev_first, Fn, 
+                          recs.size());
+          this_rec->unarm();
+        } else { // no valid lagtime
+          this_rec->schedule(future, pool, horizon, addl_ev_first, Fn, 
+                             recs.size());
+        }
+      } // from data
+
+      // This block gets hit for any and all infusions; sometimes the
+      // infusion just got started and we need to add the lag time
+      // sometimes it is an infusion via addl and lag time is already there
+      if(this_rec->int_infusion() && this_rec->armed()) {
+        rec_ptr evoff = pool.make(this_rec->cmt(),
+                                  9,
+                                  this_rec->amt(),
+                                  this_rec->time() + this_rec->dur(Fn),
+                                  this_rec->rate(),
+                                  -299,
+                                  this_rec->id());
+        if(this_rec->from_data()) {
+          evoff->time(evoff->time() + prob->alag(this_cmtn));
+        }
+        future.push(evoff);
+      }
+
+      if(tad) {
+        if((this_rec->evid()==1)) {
+          if(this_rec->armed()) {
+            told = tto - prob->alag(this_cmtn);
+          }
+        }
+      }
+    } // is_dose
+
+    if(dense) {
+      double tstop = next_event[jd];
+      if(!future.empty()) tstop = std::min(tstop, future.top()->time());
+      if(save != NULL) tstop = std::min(tstop, save->time);
+      prob->tstop(tstop);
+    }
+    prob->watch_roots();
+
+    prob->advance(tfrom,tto);
+
+    // A $ROOT function crossed zero on the way; the crossing becomes a
+    // record of its own and this record is taken up again after it
+    if(prob->root_found()) {
+      root_rec = pool.make(1, 2, 0.0, prob->root_time(), 0.0, __ROOT_POS, id);
+      root_rec->phantom_rec();
+      root_rec->unarm();
+      root_k = prob->root_found();
+      future.push(root_rec);
+      resumed.push_back(this_rec);
+      if(done == this_rec) {
+        future.push(this_rec);
+        done = NULL;
+      } else {
+        --jd;
+      }
+      tfrom = prob->root_time();
+      continue;
+    }
+
+    if(this_rec->evid() != 2) {
+      this_rec->implement(prob);
+    }
+
+    if(locf) {
+      data->copy_parameters(this_rec->pos(), prob);
+    }
+
+    if((nsens > 0) && this_rec->output()) {
+      prob->table_call_sens();
+    } else {
+      prob->table_call();
+    }
+
+    if(prob->any_mtime()) {
+      if(prob->newind() <=1) mtimehx.clear();
+      std::vector<mrgsolve::evdata> mt  = prob->mtimes();
+      for(size_t mti = 0; mti < mt.size(); ++mti) {
+        double this_time = (mt[mti]).time;
+        if(this_time < tto) continue;
+        unsigned int this_evid = (mt[mti]).evid;
+        double this_amt = mt[mti].amt;
+        int this_cmt = (mt[mti]).cmt;
+        if(neq!=0 && this_evid !=0) {
+          if((this_cmt == 0) || (std::abs(this_cmt) > int(neq))) {
+            std::ostringstream msg;
+            msg << "Compartment number in modeled event out of range: ";
+            msg << this_cmt << ".";
+            throw mrgsolve_error(msg.str());
+          }
+        }
+        if(mt[mti].now) {
+          datarecord now_ev(this_cmt,this_evid,this_amt,this_time,0.0);
+          now_ev.phantom_rec();
+          now_ev.implement(prob);
+        } else {
+          bool foo = CompEqual(mtimehx,this_time,this_evid,this_cmt);
+          if(!foo) {
+            rec_ptr new_ev = pool.make(this_cmt,this_evid,this_amt,this_time,0.0);
+            new_ev->phantom_rec();
+            future.push(new_ev);
+            mtimehx.push_back(new_ev);
+          }
+        }
+      }
+      prob->clear_mtime();
+    }
+
+    if(this_rec->output()) {
+      output_row(crow, id, this_rec->time(), prob);
+      if(tad) {
+        Ans[crow + 2*Ans_nrow] = (told > -1) ? (tto - told) : tto - tofd.at(i);
+      }
+      ++crow;
+    }
+    if(this_rec->evid()==2) {
+      this_rec->implement(prob);
+    }
+    tfrom = tto;
+  }
+
+  if(save != NULL) {
+    prob->save(save->state);
+    save->tfrom = tfrom;
+    save->told = told;
+    save->rows = crow - crow0;
+    save->last = recs.front()->time();
+    for(size_t r = 0; r < recs.size(); ++r) {
+      if(recs[r]->time() >= save->time) break;
+      save->last = recs[r]->time();
+    }
+    save->pending.clear();
+    recheap left = future;
+    while(!left.empty()) {
+      save->pending.push_back(*left.top());
+      left.pop();
+    }
+    save->modeled.clear();
+    for(size_t r = 0; r < mtimehx.size(); ++r) {
+      save->modeled.push_back(*mtimehx[r]);
+    }
+    save->saved = true;
+  }
+}
+
+/**
+ * Simulate all subjects.  With a single <code>odeproblem</code> object,
+ * subjects are simulated in order on the calling thread.  With more than
+ * one object, subjects are handed out to worker threads (one thread per
+ * object, but no more threads than subjects).  Before the first subject 
+ * on a thread, parameters are loaded from the last data set record of the
+ * previous subject so that carried-forward parameters match the serial 
+ * run.
+ *
+ * Errors in any subject stop the run; the error for the lowest subject
+ * index is re-thrown on the calling thread.
+ *
+ * Records created while simulating (lagged doses, additional doses,
+ * infusion ends and modeled events) come from one pool per thread; each
+ * pool is reused from one subject to the next.
+ *
+ * @param a the record stack
+ * @param probs one <code>odeproblem</code> object for each thread
+ * @param save if not <code>NULL</code>, one checkpoint for each subject;
+ * subjects are simulated up to the checkpoint time and saved there (see
+ * <code>simrun::id</code>)
+ */
+void simrun::run(recstack& a, std::vector<odeproblem*>& probs,
+                 std::vector<checkpoint>* save) {
+
+  for(size_t t = 0; t < probs.size(); ++t) {
+    probs[t]->nid(dat->nid());
+    probs[t]->nrow(NN);
+    probs[t]->idn(0);
+    probs[t]->rown(0);
+  }
+
+  if(firstrow.size() != a.size()) first_rows(a);
+
+#ifdef _OPENMP
+  const int nthreads = std::max(std::min(probs.size(), a.size()), size_t(1));
+#else
+  const int nthreads = 1;
+#endif
+  for(size_t t = 0; t < probs.size(); ++t) probs[t]->threaded(nthreads > 1);
+
+  while(Pools.size() < size_t(nthreads)) Pools.push_back(new recpool());
+
+  if(nthreads <= 1) {
+    odeproblem* prob = probs.at(0);
+    prob->config_call();
+    for(size_t i=0; i < a.size(); ++i) {
+      this->id(i, a[i], prob, firstrow[i], *Pools[0], 0, 
+               save == NULL ? NULL : &(*save)[i]);
+    }
+    return;
+  }
+
+#ifdef _OPENMP
+  const int nid = a.size();
+  std::vector<std::string> errors(nid);
+  std::string config_error;
+  int failed = 0;
+
+#pragma omp parallel num_threads(nthreads)
+{
+  odeproblem* prob = probs[omp_get_thread_num()];
+  recpool& pool = *Pools[omp_get_thread_num()];
+  int last = -1;
+  try {
+    prob->config_call();
+  } catch(std::exception& e) {
+#pragma omp critical
+{
+  config_error = e.what();
+}
+#pragma omp atomic write
+failed = 1;
+  }
+
+#pragma omp for schedule(dynamic)
+  for(int i = 0; i < nid; ++i) {
+    int stop;
+#pragma omp atomic read
+    stop = failed;
+    if(stop) continue;
+    try {
+      if((i > 0) && (last != i-1)) {
+        dat->copy_parameters(dat->end(i-1), prob);
+      }
+      this->id(i, a[i], prob, firstrow[i], pool, 0, 
+               save == NULL ? NULL : &(*save)[i]);
+    } catch(std::exception& e) {
+      errors[i] = e.what();
+#pragma omp atomic write
+      failed = 1;
+    } catch(...) {
+      std::ostringstream msg;
+      msg << "unknown error while simulating ID " << dat->get_uid(i) << ".";
+      errors[i] = msg.str();
+#pragma omp atomic write
+      failed = 1;
+    }
+    last = i;
+  }
+}
+
+  if(failed) {
+    if(config_error.size() > 0) throw mrgsolve_error(config_error);
+    for(int i = 0; i < nid; ++i) {
+      if(errors[i].size() > 0) throw mrgsolve_error(errors[i]);
+    }
+  }
+#endif
+}
+
+/**
+ * Simulate one subject for one set of parameters.  The subject's data set
+ * records are copied first because simulating changes some of them; 
+ * observations from the time grid are used as they are.
+ *
+ * @param k the parameter set (row in <code>param</code>)
+ * @param i the subject index
+ * @param a the record stack
+ * @param param parameter sets; <code>K</code> by <code>npar</code>, 
+ * column-major
+ * @param K the number of parameter sets
+ * @param npar the number of parameters
+ * @param nrow the number of output rows for each set
+ * @param prob the odeproblem object to use
+ * @param pool storage for records that are created while simulating
+ * @param copies storage for the copied records
+ * @param recs the subject's records for this set
+ */
+void simrun::scenario(const size_t k, const size_t i, recstack& a,
+                      const double* param, const int K, const int npar,
+                      const unsigned int nrow, odeproblem* prob,
+                      recpool& pool, recpool& copies, reclist& recs) {
+  for(int j = 0; j < npar; ++j) prob->param(j, param[k + j*K]);
+  if(i > 0) dat->copy_parameters(dat->end(i-1), prob);
+  const size_t rep = replicate ? k : 0;
+  prob->stream_replicate(rep);
+  copies.clear();
+  recs.assign(a[i].begin(), a[i].end());
+  for(size_t r = 0; r < recs.size(); ++r) {
+    if(recs[r]->from_data()) recs[r] = copies.make(*recs[r]);
+  }
+  this->id(i, recs, prob, k*nrow + firstrow[i], pool, rep);
+}
+
+/**
+ * Simulate all subjects once for each set of parameters.  The output 
+ * matrix holds one block of <code>nrow</code> rows for each set, in the 
+ * order of the rows in <code>param</code>.  Each set starts from its 
+ * parameters the way a run with <code>run</code> would.  ETAs and EPS are 
+ * the same for every set unless <code>replicate</code> is set; then each
+ * set is a replicate with its own ETAs (rows in <code>eta</code>, or
+ * streams) and EPS.  With more than one <code>odeproblem</code> 
+ * object, every combination of set and subject is handed out to the worker
+ * threads, so sets are simulated in parallel even when there is only one 
+ * subject.
+ *
+ * Errors stop the sweep; the error for the first set and subject is 
+ * re-thrown on the calling thread.
+ *
+ * @param a the record stack
+ * @param probs one <code>odeproblem</code> object for each thread
+ * @param param parameter sets; one row per set and one column for each 
+ * model parameter
+ * @param nrow the number of output rows for each set
+ */
+void simrun::sweep(recstack& a, std::vector<odeproblem*>& probs,
+                   const Rcpp::NumericMatrix& param, 
+                   const unsigned int nrow) {
+
+  for(size_t t = 0; t < probs.size(); ++t) {
+    probs[t]->nid(dat->nid());
+    probs[t]->nrow(NN);
+    probs[t]->idn(0);
+    probs[t]->rown(0);
+  }
+
+  if(firstrow.size() != a.size()) first_rows(a);
+
+  const int nid = a.size();
+  const int K = param.nrow();
+  const int npar = param.ncol();
+  const double* par = param.begin();
+  const int ntask = K * nid;
+
+#ifdef _OPENMP
+  const int nthreads = std::max(std::min(int(probs.size()), ntask), 1);
+#else
+  const int nthreads = 1;
+#endif
+  for(size_t t = 0; t < probs.size(); ++t) probs[t]->threaded(nthreads > 1);
+
+  while(Pools.size() < size_t(nthreads)) Pools.push_back(new recpool());
+  while(Copies.size() < size_t(nthreads)) Copies.push_back(new recpool());
+
+  if(nthreads <= 1) {
+    odeproblem* prob = probs.at(0);
+    reclist recs;
+    prob->config_call();
+    for(int n = 0; n < ntask; ++n) {
+      scenario(n / nid, n % nid, a, par, K, npar, nrow, prob, *Pools[0],
+               *Copies[0], recs);
+    }
+    return;
+  }
+
+#ifdef _OPENMP
+  std::vector<std::string> errors(ntask);
+  std::string config_error;
+  int failed = 0;
+
+#pragma omp parallel num_threads(nthreads)
+{
+  odeproblem* prob = probs[omp_get_thread_num()];
+  recpool& pool = *Pools[omp_get_thread_num()];
+  recpool& copies = *Copies[omp_get_thread_num()];
+  reclist recs;
+  try {
+    prob->config_call();
+  } catch(std::exception& e) {
+#pragma omp critical
+{
+  config_error = e.what();
+}
+#pragma omp atomic write
+failed = 1;
+  }
+
+#pragma omp for schedule(dynamic)
+  for(int n = 0; n < ntask; ++n) {
+    int stop;
+#pragma omp atomic read
+    stop = failed;
+    if(stop) continue;
+    try {
+      scenario(n / nid, n % nid, a, par, K, npar, nrow, prob, pool, copies,
+               recs);
+    } catch(std::exception& e) {
+      errors[n] = e.what();
+#pragma omp atomic write
+      failed = 1;
+    } catch(...) {
+      std::ostringstream msg;
+      msg << "unknown error while simulating ID " << dat->get_uid(n % nid);
+      msg << ".";
+      errors[n] = msg.str();
+#pragma omp atomic write
+      failed = 1;
+    }
+  }
+}
+
+  if(failed) {
+    if(config_error.size() > 0) throw mrgsolve_error(config_error);
+    for(int n = 0; n < ntask; ++n) {
+      if(errors[n].size() > 0) throw mrgsolve_error(errors[n]);
+    }
+  }
+#endif
+}
+
+/**
+ * Pick up every subject from its checkpoint once for each branch.  Branch
+ * <code>k</code> has its own records for each subject (from the checkpoint
+ * time on) in <code>branches[k]</code>, taken from the data set in 
+ * <code>data[k]</code>; a subject can have no records in a branch.  Only 
+ * the part after the checkpoint is simulated, so the cost of a branch 
+ * depends on its own records and not on what came before.  With more than
+ * one <code>odeproblem</code> object, every combination of branch and 
+ * subject is handed out to the worker threads.
+ *
+ * Errors stop the run; the error for the first branch and subject is 
+ * re-thrown on the calling thread.
+ *
+ * @param from one saved checkpoint for each subject
+ * @param branches records for each branch and subject
+ * @param data the data set for each branch
+ * @param probs one <code>odeproblem</code> object for each thread
+ * @param rows the first output row for each branch and subject; subject 
+ * <code>i</code> in branch <code>k</code> is at 
+ * <code>k*nid + i</code>
+ */
+void simrun::branch(const std::vector<checkpoint>& from,
+                    std::vector<recstack>& branches,
+                    std::vector<dataobject>& data,
+                    std::vector<odeproblem*>& probs,
+                    const std::vector<unsigned int>& rows) {
+
+  for(size_t t = 0; t < probs.size(); ++t) {
+    probs[t]->nid(dat->nid());
+    probs[t]->nrow(NN);
+  }
+
+  const int nid = from.size();
+  const int ntask = branches.size() * nid;
+
+#ifdef _OPENMP
+  const int nthreads = std::max(std::min(int(probs.size()), ntask), 1);
+#else
+  const int nthreads = 1;
+#endif
+  for(size_t t = 0; t < probs.size(); ++t) probs[t]->threaded(nthreads > 1);
+
+  while(Pools.size() < size_t(nthreads)) Pools.push_back(new recpool());
+
+  if(nthreads <= 1) {
+    odeproblem* prob = probs.at(0);
+    prob->config_call();
+    for(int n = 0; n < ntask; ++n) {
+      const int k = n / nid;
+      const int i = n % nid;
+      this->id(i, branches[k][i], prob, rows[n], *Pools[0], 0, NULL, 
+               &from[i], &data[k]);
+    }
+    return;
+  }
+
+#ifdef _OPENMP
+  std::vector<std::string> errors(ntask);
+  std::string config_error;
+  int failed = 0;
+
+#pragma omp parallel num_threads(nthreads)
+{
+  odeproblem* prob = probs[omp_get_thread_num()];
+  recpool& pool = *Pools[omp_get_thread_num()];
+  try {
+    prob->config_call();
+  } catch(std::exception& e) {
+#pragma omp critical
+{
+  config_error = e.what();
+}
+#pragma omp atomic write
+failed = 1;
+  }
+
+#pragma omp for schedule(dynamic)
+  for(int n = 0; n < ntask; ++n) {
+    int stop;
+#pragma omp atomic read
+    stop = failed;
+    if(stop) continue;
+    const int k = n / nid;
+    const int i = n % nid;
+    try {
+      this->id(i, branches[k][i], prob, rows[n], pool, 0, NULL, &from[i],
+               &data[k]);
+    } catch(std::exception& e) {
+      errors[n] = e.what();
+#pragma omp atomic write
+      failed = 1;
+    } catch(...) {
+      std::ostringstream msg;
+      msg << "unknown error while simulating ID " << dat->get_uid(i) << ".";
+      errors[n] = msg.str();
+#pragma omp atomic write
+      failed = 1;
+    }
+  }
+}
+
+  if(failed) {
+    if(config_error.size() > 0) throw mrgsolve_error(config_error);
+    for(int n = 0; n < ntask; ++n) {
+      if(errors[n].size() > 0) throw mrgsolve_error(errors[n]);
+    }
+  }
+#endif
+}
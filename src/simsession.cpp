@@ -0,0 +1,916 @@
+// Copyright (C) 2013 - 2019  Metrum Research Group, LLC
+//
+// This file is part of mrgsolve.
+//
+// mrgsolve is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// mrgsolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with mrgsolve.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file simsession.cpp
+ *
+ */
+
+#include <string>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "mrgsolve.h"
+#include "odeproblem.h"
+#include "dataobject.h"
+#include "simrun.h"
+#include "simsession.h"
+#include "RcppInclude.h"
+
+#define CRUMP(a) throw Rcpp::exception(a,false)
+
+/**
+ * Set up a simulation problem.  Arguments are the same as for
+ * <code>DEVTRAN</code>.
+ */
+simsession::simsession(const Rcpp::List& parin,
+                       const Rcpp::NumericVector& inpar,
+                       const Rcpp::CharacterVector& parnames,
+                       const Rcpp::NumericVector& init,
+                       Rcpp::CharacterVector& cmtnames,
+                       const Rcpp::IntegerVector& capture,
+                       const Rcpp::List& funs,
+                       const Rcpp::NumericMatrix& data,
+                       const Rcpp::NumericMatrix& idata,
+                       Rcpp::NumericMatrix& OMEGA,
+                       Rcpp::NumericMatrix& SIGMA,
+                       Rcpp::Environment envir) :
+  Envir(envir), Dat(data, parnames), Idat(idata, parnames, cmtnames) {
+  Sim = NULL;
+  Parnames = parnames;
+  Nid = 0;
+  Neq = 0;
+  Npar = inpar.size();
+  Neta = 0;
+  Neps = 0;
+  Req_start = 0;
+  Stream_seed = 0;
+  Streaming = false;
+  Digits = 0;
+  Tscale = 1.0;
+  Grid_pos = 0;
+  Runs = 0;
+  try {
+    setup(parin, inpar, init, capture, funs, data, idata, OMEGA, SIGMA);
+  } catch(...) {
+    release();
+    throw;
+  }
+}
+
+simsession::~simsession() {
+  release();
+}
+
+void simsession::release() {
+  delete Sim;
+  Sim = NULL;
+  for(size_t t = 0; t < Probs.size(); ++t) delete Probs[t];
+  Probs.clear();
+}
+
+void simsession::setup(const Rcpp::List& parin,
+                       const Rcpp::NumericVector& inpar,
+                       const Rcpp::NumericVector& init,
+                       const Rcpp::IntegerVector& capture,
+                       const Rcpp::List& funs,
+                       const Rcpp::NumericMatrix& data,
+                       const Rcpp::NumericMatrix& idata,
+                       Rcpp::NumericMatrix& OMEGA,
+                       Rcpp::NumericMatrix& SIGMA) {
+
+  //const unsigned int verbose  = Rcpp::as<int>    (parin["verbose"]);
+  const bool debug            = Rcpp::as<bool>   (parin["debug"]);
+  Digits                      = Rcpp::as<int>    (parin["digits"]);
+  Tscale                      = Rcpp::as<double> (parin["tscale"]);
+  const bool obsonly          = Rcpp::as<bool>   (parin["obsonly"]);
+  bool obsaug                 = Rcpp::as<bool>   (parin["obsaug"] );
+  obsaug = obsaug & (data.nrow() > 0);
+  const int  recsort          = Rcpp::as<int>    (parin["recsort"]);
+  const bool filbak           = Rcpp::as<bool>   (parin["filbak"]);
+  const double mindt          = Rcpp::as<double> (parin["mindt"]);
+  const bool tad              = Rcpp::as<bool>   (parin["tad"]);
+  const bool nocb             = Rcpp::as<bool>   (parin["nocb"]);
+  const bool dense            = Rcpp::as<bool>   (parin["dense"]);
+  int nthreads                = Rcpp::as<int>    (parin["nthreads"]);
+
+  // Create data objects from data and idata
+  Dat.map_uid();
+  Dat.locate_tran();
+
+  Idat.idata_row();
+
+  // Number of individuals in the data set
+  const int NID = Dat.nid();
+  const int nidata = Idat.nrow();
+  Nid = NID;
+
+  int j = 0;
+  unsigned int crow = 0;
+  size_t h = 0;
+
+  bool put_ev_first = false;
+  bool addl_ev_first = true;
+
+  switch (recsort) {
+  case 1:
+    break;
+  case 2:
+    put_ev_first = false;
+    addl_ev_first = false;
+    break;
+  case 3:
+    put_ev_first = true;
+    addl_ev_first = true;
+    break;
+  case 4:
+    put_ev_first = true;
+    addl_ev_first = false;
+    break;
+  default:
+    CRUMP("recsort must be 1, 2, 3, or 4.");
+  }
+
+  // Requested compartments
+  Rcpp::IntegerVector request = parin["request"];
+  const unsigned int nreq = request.size();
+
+  // Columns from the data set to carry:
+  Rcpp::CharacterVector data_carry_ =
+    Rcpp::as<Rcpp::CharacterVector >(parin["carry_data"]);
+  const Rcpp::IntegerVector data_carry =  Dat.get_col_n(data_carry_);
+  const unsigned int n_data_carry = data_carry.size();
+
+  // Columns from the idata set to carry:
+  unsigned int n_idata_carry=0;
+  Rcpp::IntegerVector idata_carry;
+  if(nidata > 0) {
+    Rcpp::CharacterVector idata_carry_ =
+      Rcpp::as<Rcpp::CharacterVector >(parin["carry_idata"]);
+    idata_carry =  Idat.get_col_n(idata_carry_);
+    n_idata_carry = idata_carry.size();
+    Dat.check_idcol(Idat);
+  }
+
+  // Tran Items to carry:
+  Rcpp::CharacterVector tran_carry =
+    Rcpp::as<Rcpp::CharacterVector >(parin["carry_tran"]);
+  const unsigned int n_tran_carry = tran_carry.size();
+
+  // Captures
+  const unsigned int n_capture  = capture.size()-1;
+
+  // Create odeproblem object
+  odeproblem *prob  = new odeproblem(inpar, init, funs, capture.at(0));
+  Probs.push_back(prob);
+  prob->omega(OMEGA);
+  prob->sigma(SIGMA);
+  prob->copy_parin(parin);
+  prob->pass_envir(&Envir);
+  const unsigned int neq = prob->neq();
+  const unsigned int nsens = prob->nsens();
+  Neq = neq;
+
+  // Runs use no more threads than there are subjects; sweeps can use them
+  // all
+#ifndef _OPENMP
+  nthreads = 1;
+#endif
+  if(nthreads < 1) nthreads = 1;
+
+  recstack& a = A;
+  a.resize(NID);
+
+  unsigned int obscount = 0;
+  unsigned int evcount = 0;
+  Dat.get_records(a, Pool, NID, neq, obscount, evcount, obsonly, debug);
+
+  // Find tofd
+  std::vector<double> tofd;
+  if(tad) {
+    tofd.reserve(a.size());
+    for(recstack::const_iterator it = a.begin(); it !=a.end(); ++it) {
+      for(reclist::const_iterator itt = it->begin(); itt != it->end(); ++itt) {
+        if((*itt)->evid()==1) {
+          tofd.push_back((*itt)->time());
+          break;
+        }
+      }
+    }
+    if(tofd.size()==0) {
+      tofd.resize(a.size(),0.0);
+    }
+    if(tofd.size() != a.size()) {
+      CRUMP("There was a problem finding time of first dose.");
+    }
+  }
+
+  // Need this for later
+  int nextpos = put_ev_first ?  (data.nrow() + 10) : -100;
+
+  if((obscount == 0) || (obsaug)) {
+
+    Rcpp::NumericMatrix tgrid =
+      Rcpp::as<Rcpp::NumericMatrix>(parin["tgridmatrix"]);
+
+    bool multiple_tgrid = tgrid.ncol() > 1;
+
+    // Already has C indexing
+    Rcpp::IntegerVector tgridi =
+      Rcpp::as<Rcpp::IntegerVector>(parin["whichtg"]);
+
+    // Number of non-na times in each design
+    std::vector<int> tgridn;
+
+    if(multiple_tgrid) {
+      if(tgridi.size() < idata.nrow()) {
+        CRUMP("Length of design indicator less than NID.");
+      }
+      if(max(tgridi) >= tgrid.ncol()) {
+        CRUMP("Insufficient number of designs specified for this problem.");
+      }
+      for(int i = 0; i < tgrid.ncol(); ++i) {
+        tgridn.push_back(Rcpp::sum(!Rcpp::is_na(tgrid(Rcpp::_,i))));
+      }
+    } else {
+      tgridn.push_back(tgrid.nrow());
+      if(tgridi.size() == 0) {
+        tgridi = Rcpp::rep(0,NID);
+      }
+      Grid.assign(tgrid.begin(), tgrid.begin() + tgrid.nrow());
+      Grid_pos = nextpos;
+    }
+
+    // Create a common dictionary of observation events
+    // Vector of vectors
+    // Outer vector: length = number of designs
+    // Inner vector: length = number of times in that design
+    std::vector<std::vector<rec_ptr> > designs;
+
+    designs.reserve(tgridn.size());
+
+    for(size_t i = 0; i < tgridn.size(); ++i) {
+
+      std::vector<rec_ptr> z;
+
+      z.reserve(tgridn[i]);
+
+      for(int j = 0; j < tgridn[i]; ++j) {
+        rec_ptr obs = Pool.make(tgrid(j,i),nextpos,true);
+        z.push_back(obs);
+      }
+      designs.push_back(z);
+    }
+
+    double id;
+    size_t n;
+
+    // We have to look up the design from the idata set
+    for(recstack::iterator it = a.begin(); it != a.end(); ++it) {
+      if(multiple_tgrid) {
+        id = Dat.get_uid(it-a.begin());
+        j  = Idat.get_idata_row(id);
+        n  = tgridn.at(tgridi.at(j));
+      } else {
+        j = 0;
+        n = tgridn.at(0);
+      }
+
+      it->reserve((it->size() + n));
+      for(h=0; h < n; h++) {
+        it->push_back(designs[tgridi[j]][h]);
+        ++obscount;
+      }
+      std::sort(it->begin(), it->end(), CompRec());
+    }
+  }
+
+  // Keep the data set records as they are now; they go back this way
+  // before every run
+  for(recstack::const_iterator it = a.begin(); it != a.end(); ++it) {
+    for(reclist::const_iterator itt = it->begin(); itt != it->end(); ++itt) {
+      if(!(*itt)->from_data()) continue;
+      Recs.push_back(*itt);
+      Saved.push_back(**itt);
+    }
+  }
+
+  // Create results matrix:
+  //  rows: ntime*nset
+  //  cols: rep, time, eq[0], eq[1], ..., yout[0], yout[1],...
+  //  then the sensitivities of eq and yout for each parameter
+  const unsigned int NN = obsonly ? obscount : (obscount + evcount);
+  int precol = 2 + int(tad);
+  const unsigned int n_out_col  = precol + n_tran_carry
+    + n_data_carry + n_idata_carry + nreq + n_capture
+    + nsens*(nreq + n_capture);
+  Rcpp::NumericMatrix ans(NN,n_out_col);
+  const unsigned int tran_carry_start = precol;
+  const unsigned int data_carry_start = tran_carry_start + n_tran_carry;
+  const unsigned int idata_carry_start = data_carry_start + n_data_carry;
+  const unsigned int req_start = idata_carry_start+n_idata_carry;
+  const unsigned int capture_start = req_start+nreq;
+  const unsigned int sens_start = capture_start+n_capture;
+  Req_start = req_start;
+
+  // ETA are either drawn for each run from the R random number generator
+  // or drawn per subject from streams keyed on stream_seed.  EPS are always
+  // drawn from the streams as they are needed; without stream_seed, the
+  // streams are seeded from the R random number generator for each run.
+  Stream_seed = Rcpp::as<int>(parin["stream_seed"]);
+  Streaming = Stream_seed != NA_INTEGER;
+
+  Neta = OMEGA.nrow();
+  if(Neta > 0) {
+    prob->neta(Neta);
+  }
+
+  Neps = SIGMA.nrow();
+  if(Neps > 0) {
+    prob->neps(Neps);
+  }
+
+  if(n_tran_carry > 0) {
+
+    Rcpp::CharacterVector::iterator tcbeg  = tran_carry.begin();
+    Rcpp::CharacterVector::iterator tcend  = tran_carry.end();
+
+    const bool carry_evid = std::find(tcbeg,tcend, "evid")  != tcend;
+    const bool carry_cmt =  std::find(tcbeg,tcend, "cmt")   != tcend;
+    const bool carry_amt =  std::find(tcbeg,tcend, "amt")   != tcend;
+    const bool carry_ii =   std::find(tcbeg,tcend, "ii")    != tcend;
+    const bool carry_addl = std::find(tcbeg,tcend, "addl")  != tcend;
+    const bool carry_ss =   std::find(tcbeg,tcend, "ss")    != tcend;
+    const bool carry_rate = std::find(tcbeg,tcend, "rate")  != tcend;
+    const bool carry_aug  = std::find(tcbeg,tcend, "a.u.g") != tcend;
+
+    if(carry_evid) Tran_names.push_back("evid");
+    if(carry_amt)  Tran_names.push_back("amt");
+    if(carry_cmt)  Tran_names.push_back("cmt");
+    if(carry_ss)   Tran_names.push_back("ss");
+    if(carry_ii)   Tran_names.push_back("ii");
+    if(carry_addl) Tran_names.push_back("addl");
+    if(carry_rate) Tran_names.push_back("rate");
+    if(carry_aug)  Tran_names.push_back("a.u.g");
+
+
+    crow = 0;
+    int n = 0;
+    for(recstack::const_iterator it = a.begin(); it !=a.end(); ++it) {
+      for(reclist::const_iterator itt = it->begin(); itt != it->end(); ++itt) {
+        if(!(*itt)->output()) continue;
+        n = 0;
+        if(carry_evid) {ans(crow,n+precol) = (*itt)->evid();                     ++n;}
+        if(carry_amt)  {ans(crow,n+precol) = (*itt)->amt();                      ++n;}
+        if(carry_cmt)  {ans(crow,n+precol) = (*itt)->cmt();                      ++n;}
+        if(carry_ss)   {ans(crow,n+precol) = (*itt)->ss();                       ++n;}
+        if(carry_ii)   {ans(crow,n+precol) = (*itt)->ii();                       ++n;}
+        if(carry_addl) {ans(crow,n+precol) = (*itt)->addl();                     ++n;}
+        if(carry_rate) {ans(crow,n+precol) = (*itt)->rate();                     ++n;}
+        if(carry_aug)  {ans(crow,n+precol) = ((*itt)->pos()==nextpos) && obsaug; ++n;}
+        ++crow;
+      }
+    }
+  }
+
+  if(((n_idata_carry > 0) || (n_data_carry > 0)) ) {
+    Dat.carry_out(a,ans,Idat,data_carry,data_carry_start,
+                  idata_carry,idata_carry_start);
+  }
+  Ans = ans;
+
+  Sim = new simrun(&Dat, &Idat, Ans);
+  Sim->tad = tad;
+  Sim->nocb = nocb;
+  Sim->filbak = filbak;
+  Sim->addl_ev_first = addl_ev_first;
+  Sim->mindt = mindt;
+  Sim->dense = dense;
+  Sim->neq = neq;
+  Sim->neta = Neta;
+  Sim->neps = Neps;
+  Sim->init.assign(init.begin(), init.end());
+  Sim->tofd = tofd;
+  Sim->capture(capture, capture_start);
+  Sim->request(request, req_start);
+  Sim->sens(nsens, sens_start);
+  Sim->first_rows(a);
+
+  // One odeproblem object for each thread; the first one is shared with
+  // the serial run
+  for(int t = 1; t < nthreads; ++t) {
+    odeproblem* tprob = new odeproblem(inpar, init, funs, capture.at(0));
+    Probs.push_back(tprob);
+    tprob->omega(OMEGA);
+    tprob->sigma(SIGMA);
+    tprob->copy_parin(parin);
+    tprob->pass_envir(&Envir);
+    tprob->neta(Neta);
+    tprob->neps(Neps);
+  }
+}
+
+/**
+ * Put the data set records back the way they were when the session was
+ * created.  Simulating changes some of them: infusion rates that come
+ * from the model are filled in and doses with a lag time are unarmed.
+ */
+void simsession::reset_records() {
+  for(size_t k = 0; k < Recs.size(); ++k) *Recs[k] = Saved[k];
+}
+
+/**
+ * Set ETAs and seed the random streams for a run.
+ *
+ * @param eta ETA values with one row per subject; when there are no rows,
+ * ETAs are drawn from <code>OMEGA</code> (or from the random streams when
+ * there is a stream seed)
+ * @param nrep the number of replicates to draw ETAs for
+ * @param stream_eps if <code>true</code>, EPS come from the random streams 
+ * even without a stream seed
+ */
+void simsession::random_effects(const Rcpp::NumericMatrix& eta,
+                                const int nrep, const bool stream_eps) {
+  if(eta.nrow() > 0) {
+    if(Streaming) {
+      CRUMP("ETA can't be given when they come from the random streams.");
+    }
+    if((eta.nrow() != int(Nid)) || (eta.ncol() != int(Neta))) {
+      CRUMP("ETA must have one row per subject and one column per ETA.");
+    }
+    Sim->eta = Rcpp::as<arma::mat>(eta);
+  } else if((Neta > 0) && !Streaming) {
+    Sim->eta = Probs[0]->mv_omega(Nid*nrep);
+  }
+
+  // Without a stream seed, EPS come from the R random number generator
+  // as they are needed unless the run uses more than one thread or the
+  // caller needs the same EPS to come back (like every set in a sweep)
+  const bool eps = Streaming || (Probs.size() > 1) || stream_eps;
+  int seed = Stream_seed;
+  if(!Streaming) {
+    seed = 0;
+    if((Neps > 0) && eps) seed = static_cast<int>(unif_rand()*2147483647.0);
+  }
+  for(size_t t = 0; t < Probs.size(); ++t) {
+    Probs[t]->stream_seed(seed, Streaming, eps);
+  }
+}
+
+/**
+ * Collect the outcomes of a run and finish the output.
+ *
+ * @param ans the output matrix
+ * @param err the error from the run, if any; it is thrown once the
+ * outcomes are collected
+ * @return see <code>DEVTRAN</code>
+ */
+Rcpp::List simsession::results(Rcpp::NumericMatrix& ans,
+                               const std::string& err) {
+
+  // Steady state outcomes from every thread, in subject order
+  std::vector<ssinfo> ssres;
+  int ss_fail = 0;
+  Rcpp::NumericVector ss_cache(2);
+  // ODE solver steps, derivative and Jacobian evaluations
+  Rcpp::NumericVector solver_stats(3);
+  for(size_t t = 0; t < Probs.size(); ++t) {
+    const std::vector<ssinfo>& r = Probs[t]->ss_results();
+    ssres.insert(ssres.end(), r.begin(), r.end());
+    ss_fail += Probs[t]->ss_fail();
+    ss_cache[0] += Probs[t]->ss_hits();
+    ss_cache[1] += Probs[t]->ss_misses();
+    solver_stats[0] += Probs[t]->nstep();
+    solver_stats[1] += Probs[t]->nrhs();
+    solver_stats[2] += Probs[t]->njac();
+  }
+  std::stable_sort(ssres.begin(), ssres.end(), CompSsinfo);
+
+  if(err.size() > 0) {
+    CRUMP(err.c_str());
+  }
+
+  // ID, time, cmt, iter, converged, cached
+  Rcpp::NumericMatrix ss(ssres.size(), 6);
+  for(size_t k = 0; k < ssres.size(); ++k) {
+    ss(k,0) = ssres[k].id;
+    ss(k,1) = ssres[k].time;
+    ss(k,2) = ssres[k].cmt;
+    ss(k,3) = ssres[k].iter;
+    ss(k,4) = ssres[k].converged;
+    ss(k,5) = ssres[k].cached;
+  }
+
+  if(Digits > 0) {
+    for(int i=Req_start; i < ans.ncol(); ++i) {
+      ans(Rcpp::_, i) = signif(ans(Rcpp::_,i), Digits);
+    }
+  }
+  if((Tscale != 1) && (Tscale >= 0)) {
+    ans(Rcpp::_,1) = ans(Rcpp::_,1) * Tscale;
+  }
+  return Rcpp::List::create(Rcpp::Named("data") = ans,
+                            Rcpp::Named("trannames") = Tran_names,
+                            Rcpp::Named("ss") = ss,
+                            Rcpp::Named("ss_fail") = ss_fail,
+                            Rcpp::Named("ss_cache") = ss_cache,
+                            Rcpp::Named("solver_stats") = solver_stats);
+}
+
+/**
+ * Simulate the data set.
+ *
+ * Every problem starts from <code>param</code>; data set records go back
+ * to the way they were when the session was created.  The first run
+ * writes into the output template; later runs write into a copy of it so
+ * results that were already returned don't change.
+ *
+ * @param param values for all model parameters
+ * @param eta ETA values with one row per subject, or no rows; see
+ * <code>random_effects</code>
+ * @return list with the simulated data and the run outcomes; see
+ * <code>DEVTRAN</code>
+ */
+Rcpp::List simsession::run(const Rcpp::NumericVector& param,
+                           const Rcpp::NumericMatrix& eta) {
+
+  if(param.size() != int(Npar)) {
+    CRUMP("the number of parameters doesn't match the model.");
+  }
+
+  reset_records();
+
+  for(size_t t = 0; t < Probs.size(); ++t) {
+    for(unsigned int i = 0; i < Npar; ++i) Probs[t]->param(i, param[i]);
+    Probs[t]->reset_run();
+  }
+
+  random_effects(eta);
+
+  Rcpp::NumericMatrix ans = Runs == 0 ? Ans : Rcpp::clone(Ans);
+  Sim->output(ans);
+  ++Runs;
+
+  std::string err;
+  try {
+    Sim->run(A, Probs);
+  } catch(mrgsolve_error& e) {
+    err = e.what();
+  }
+
+  return results(ans, err);
+}
+
+/**
+ * Simulate the data set once for each set of parameters.
+ *
+ * The output has one block of rows for each set, in order, with the same
+ * layout as the output from <code>run</code>.  ETAs and EPS are the same
+ * for every set.  Each set starts from the data set records the way they
+ * were when the session was created.
+ *
+ * @param param values for all model parameters; one row per set
+ * @param eta ETA values with one row per subject, or no rows; see
+ * <code>random_effects</code>
+ * @return see <code>DEVTRAN</code>
+ */
+Rcpp::List simsession::sweep(const Rcpp::NumericMatrix& param,
+                             const Rcpp::NumericMatrix& eta) {
+
+  if(param.ncol() != int(Npar)) {
+    CRUMP("the number of parameters doesn't match the model.");
+  }
+
+  reset_records();
+
+  for(size_t t = 0; t < Probs.size(); ++t) Probs[t]->reset_run();
+
+  // EPS have to be the same for every set
+  random_effects(eta, 1, true);
+
+  Rcpp::NumericMatrix ans = stacked(param.nrow());
+  Sim->output(ans);
+  ++Runs;
+
+  std::string err;
+  try {
+    Sim->sweep(A, Probs, param, Ans.nrow());
+  } catch(mrgsolve_error& e) {
+    err = e.what();
+  }
+
+  return results(ans, err);
+}
+
+/**
+ * Simulate replicates of the data set.
+ *
+ * Replicates are simulated like the sets in a sweep where every set has
+ * the same parameters, but each replicate gets its own ETAs and EPS.  
+ * Without a stream seed, all ETAs are drawn at once (one row for each 
+ * subject in each replicate); EPS and streamed ETAs come from the streams
+ * for the replicate.  With a stream seed, the first replicate is the same 
+ * as a run.
+ *
+ * @param param values for all model parameters
+ * @param nrep the number of replicates
+ * @return see <code>DEVTRAN</code>; the output has one block of rows for 
+ * each replicate
+ */
+Rcpp::List simsession::replicate(const Rcpp::NumericVector& param,
+                                 const int nrep) {
+
+  if(param.size() != int(Npar)) {
+    CRUMP("the number of parameters doesn't match the model.");
+  }
+  if(nrep < 1) {
+    CRUMP("nrep must be at least 1.");
+  }
+
+  reset_records();
+
+  for(size_t t = 0; t < Probs.size(); ++t) Probs[t]->reset_run();
+
+  random_effects(Rcpp::NumericMatrix(0,0), nrep);
+
+  Rcpp::NumericMatrix sets(nrep, Npar);
+  for(unsigned int j = 0; j < Npar; ++j) {
+    sets(Rcpp::_, j) = Rcpp::NumericVector(nrep, param[j]);
+  }
+
+  Rcpp::NumericMatrix ans = stacked(nrep);
+  Sim->output(ans);
+  ++Runs;
+
+  std::string err;
+  Sim->replicate = true;
+  try {
+    Sim->sweep(A, Probs, sets, Ans.nrow());
+  } catch(mrgsolve_error& e) {
+    err = e.what();
+  }
+  Sim->replicate = false;
+
+  return results(ans, err);
+}
+
+/**
+ * Simulate the data set up to a checkpoint and then simulate each branch
+ * from there.
+ *
+ * Data set records at or after <code>at</code> are left out; each subject
+ * is saved at the checkpoint and picked up again once for every branch 
+ * with that branch's records for the subject (see 
+ * <code>simrun::branch</code>), so the part before the checkpoint is only
+ * simulated once.  When the session added observations from the time 
+ * grid, grid times from <code>at</code> on are added to every subject in 
+ * every branch.  The output has one block of rows for each branch; in 
+ * each block, every subject has its rows from before the checkpoint 
+ * followed by its rows for the branch.
+ *
+ * @param param values for all model parameters
+ * @param eta ETA values with one row per subject, or no rows; see
+ * <code>random_effects</code>
+ * @param at the checkpoint time
+ * @param branches one data set for each branch; records have to be at or
+ * after <code>at</code> and IDs have to be in the session data set
+ * @return see <code>DEVTRAN</code>; the list also has the number of 
+ * output rows for each branch (<code>branch</code>)
+ */
+Rcpp::List simsession::fork(const Rcpp::NumericVector& param,
+                            const Rcpp::NumericMatrix& eta,
+                            const double at,
+                            const Rcpp::List& branches) {
+
+  if(param.size() != int(Npar)) {
+    CRUMP("the number of parameters doesn't match the model.");
+  }
+
+  std::map<double,int> index;
+  for(unsigned int i = 0; i < Nid; ++i) index[Dat.get_uid(i)] = i;
+
+  // Records for each branch and subject
+  const int K = branches.size();
+  std::vector<dataobject> data;
+  data.reserve(K);
+  std::vector<recstack> stacks(K, recstack(Nid));
+  recpool pool;
+  for(int k = 0; k < K; ++k) {
+    Rcpp::NumericMatrix bdata = branches[k];
+    data.push_back(dataobject(bdata, Parnames));
+    dataobject& b = data.back();
+    b.map_uid();
+    b.locate_tran();
+    recstack brecs(b.nid());
+    unsigned int obscount = 0;
+    unsigned int evcount = 0;
+    b.get_records(brecs, pool, b.nid(), Neq, obscount, evcount, false, false);
+    for(size_t j = 0; j < brecs.size(); ++j) {
+      std::map<double,int>::const_iterator it = index.find(b.get_uid(j));
+      if(it == index.end()) {
+        CRUMP("IDs in the branch data sets must be in the session data set.");
+      }
+      stacks[k][it->second].swap(brecs[j]);
+    }
+    for(unsigned int i = 0; i < Nid; ++i) {
+      reclist& recs = stacks[k][i];
+      for(size_t r = 0; r < recs.size(); ++r) {
+        if(recs[r]->time() < at) {
+          CRUMP("branch records must be at or after the checkpoint time.");
+        }
+      }
+      for(size_t g = 0; g < Grid.size(); ++g) {
+        if(Grid[g] >= at) recs.push_back(pool.make(Grid[g], Grid_pos, true));
+      }
+      std::sort(recs.begin(), recs.end(), CompRec());
+    }
+  }
+
+  // Simulate up to the checkpoint
+  reset_records();
+
+  for(size_t t = 0; t < Probs.size(); ++t) {
+    for(unsigned int i = 0; i < Npar; ++i) Probs[t]->param(i, param[i]);
+    Probs[t]->reset_run();
+  }
+
+  random_effects(eta);
+
+  Rcpp::NumericMatrix before = Rcpp::clone(Ans);
+  Sim->output(before);
+  ++Runs;
+
+  std::vector<checkpoint> saved(Nid);
+  for(unsigned int i = 0; i < Nid; ++i) saved[i].time = at;
+
+  std::string err;
+  try {
+    Sim->run(A, Probs, &saved);
+  } catch(mrgsolve_error& e) {
+    err = e.what();
+  }
+  if(err.size() > 0) return results(before, err);
+
+  // Each branch has the rows from before the checkpoint, then its own
+  std::vector<unsigned int> rows(K*Nid);
+  Rcpp::IntegerVector nrow(K);
+  unsigned int total = 0;
+  for(int k = 0; k < K; ++k) {
+    for(unsigned int i = 0; i < Nid; ++i) {
+      const reclist& recs = stacks[k][i];
+      unsigned int n = 0;
+      for(size_t r = 0; r < recs.size(); ++r) n += recs[r]->output();
+      total += saved[i].rows;
+      rows[k*Nid + i] = total;
+      total += n;
+      nrow[k] += saved[i].rows + n;
+    }
+  }
+
+  Rcpp::NumericMatrix ans(total, Ans.ncol());
+  for(int j = 0; j < Ans.ncol(); ++j) {
+    const double* from = before.begin() + j*before.nrow();
+    double* to = ans.begin() + j*total;
+    for(int k = 0; k < K; ++k) {
+      for(unsigned int i = 0; i < Nid; ++i) {
+        const double* first = from + Sim->firstrow[i];
+        std::copy(first, first + saved[i].rows, 
+                  to + rows[k*Nid + i] - saved[i].rows);
+      }
+    }
+  }
+
+  Sim->output(ans);
+
+  try {
+    Sim->branch(saved, stacks, data, Probs, rows);
+  } catch(mrgsolve_error& e) {
+    err = e.what();
+  }
+
+  Rcpp::List out = results(ans, err);
+  out.push_back(nrow, "branch");
+  return out;
+}
+
+/**
+ * Make an output matrix with <code>K</code> copies of the template, one
+ * block of rows after the other.
+ *
+ * @param K the number of copies
+ * @return the output matrix
+ */
+Rcpp::NumericMatrix simsession::stacked(const unsigned int K) {
+  const unsigned int nrow = Ans.nrow();
+  Rcpp::NumericMatrix ans(K*nrow, Ans.ncol());
+  for(int j = 0; j < Ans.ncol(); ++j) {
+    const double* from = Ans.begin() + j*nrow;
+    double* to = ans.begin() + j*K*nrow;
+    for(unsigned int k = 0; k < K; ++k) {
+      std::copy(from, from + nrow, to + k*nrow);
+    }
+  }
+  return ans;
+}
+
+/**
+ * Create a simulation session.  Arguments are the same as for
+ * <code>DEVTRAN</code>.
+ *
+ * @return external pointer to the session
+ */
+// [[Rcpp::export]]
+SEXP SESSION_NEW(const Rcpp::List parin,
+                 const Rcpp::NumericVector& inpar,
+                 const Rcpp::CharacterVector& parnames,
+                 const Rcpp::NumericVector& init,
+                 Rcpp::CharacterVector& cmtnames,
+                 const Rcpp::IntegerVector& capture,
+                 const Rcpp::List& funs,
+                 const Rcpp::NumericMatrix& data,
+                 const Rcpp::NumericMatrix& idata,
+                 Rcpp::NumericMatrix& OMEGA,
+                 Rcpp::NumericMatrix& SIGMA,
+                 Rcpp::Environment envir) {
+  simsession* s = new simsession(parin, inpar, parnames, init, cmtnames,
+                                 capture, funs, data, idata, OMEGA, SIGMA,
+                                 envir);
+  Rcpp::XPtr<simsession> ptr(s, true);
+  return ptr;
+}
+
+/**
+ * Simulate from a session.
+ *
+ * @param xp external pointer from <code>SESSION_NEW</code>
+ * @param param values for all model parameters
+ * @param eta ETA values with one row per subject, or no rows
+ * @return see <code>DEVTRAN</code>
+ */
+// [[Rcpp::export]]
+Rcpp::List SESSION_RUN(SEXP xp,
+                       const Rcpp::NumericVector& param,
+                       const Rcpp::NumericMatrix& eta) {
+  Rcpp::XPtr<simsession> ptr(xp);
+  if(ptr.get() == NULL) {
+    CRUMP("the simulation session is no longer valid.");
+  }
+  return ptr->run(param, eta);
+}
+
+/**
+ * Simulate from a session once for each set of parameters.
+ *
+ * @param xp external pointer from <code>SESSION_NEW</code>
+ * @param param values for all model parameters; one row per set
+ * @param eta ETA values with one row per subject, or no rows
+ * @return see <code>DEVTRAN</code>
+ */
+// [[Rcpp::export]]
+Rcpp::List SESSION_SWEEP(SEXP xp,
+                         const Rcpp::NumericMatrix& param,
+                         const Rcpp::NumericMatrix& eta) {
+  Rcpp::XPtr<simsession> ptr(xp);
+  if(ptr.get() == NULL) {
+    CRUMP("the simulation session is no longer valid.");
+  }
+  return ptr->sweep(param, eta);
+}
+
+/**
+ * Simulate from a session up to a checkpoint and then once for each 
+ * branch.
+ *
+ * @param xp external pointer from <code>SESSION_NEW</code>
+ * @param param values for all model parameters
+ * @param eta ETA values with one row per subject, or no rows
+ * @param at the checkpoint time
+ * @param branches one data set for each branch
+ * @return see <code>simsession::fork</code>
+ */
+// [[Rcpp::export]]
+Rcpp::List SESSION_FORK(SEXP xp,
+                        const Rcpp::NumericVector& param,
+                        const Rcpp::NumericMatrix& eta,
+                        const double at,
+                        const Rcpp::List& branches) {
+  Rcpp::XPtr<simsession> ptr(xp);
+  if(ptr.get() == NULL) {
+    CRUMP("the simulation session is no longer valid.");
+  }
+  return ptr->fork(param, eta, at, branches);
+}